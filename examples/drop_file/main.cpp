@@ -26,12 +26,13 @@ int main(int argc, char* argv[])
 
    drop_box_->on_drop = [image_ = get(image_), &view_](drop_info const& info)
    {
-      if (contains_filepaths(info.data))
+      // Iterate over the file paths in place, without copying them
+      auto paths = file_paths{info.data};
+      if (auto i = paths.begin(); i != paths.end())
       {
-         auto paths = get_filepaths(info.data);
-         if (paths.size() == 1)  // We accept only one file
+         if (std::next(i) == paths.end())  // We accept only one file
          {
-            auto const& image_path = paths[0];
+            auto image_path = std::string{*i};
             if (auto p = image_.lock())
             {
                try
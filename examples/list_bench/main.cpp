@@ -0,0 +1,131 @@
+/*=============================================================================
+   Copyright (c) 2016-2023 Joel de Guzman
+
+   Distributed under the MIT License (https://opensource.org/licenses/MIT)
+=============================================================================*/
+#include <elements/element/list.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <numeric>
+#include <random>
+
+///////////////////////////////////////////////////////////////////////////////
+// Compares the single-pass move_indices and erase_indices (list.hpp) with the
+// item-by-item erase they replaced, on vectors the size of a large list. The
+// results of both are checked to be the same.
+///////////////////////////////////////////////////////////////////////////////
+
+using namespace cycfi::elements;
+using indices_type = std::vector<std::size_t>;
+
+// The item type. Like list::cell_info, a few words.
+struct item
+{
+   double      pos;
+   double      main_axis_size;
+   std::size_t id;
+   void*       elem;
+
+   bool operator==(item const& rhs) const { return id == rhs.id; }
+};
+
+// The previous implementation
+template <typename T>
+void old_move_indices(std::vector<T>& v, std::size_t pos, indices_type const& indices)
+{
+   std::vector<T> to_move;
+   to_move.reserve(indices.size());
+
+   for (auto i = indices.crbegin(); i != indices.crend(); ++i)
+   {
+      to_move.push_back(std::move(v[*i]));
+      v.erase(v.begin()+*i);
+      if (pos > *i)
+         --pos;
+   }
+
+   auto pos_i = v.begin() + std::min(pos, v.size());
+   v.insert(pos_i, to_move.crbegin(), to_move.crend());
+}
+
+template <typename T>
+void old_erase_indices(std::vector<T>& v, indices_type const& indices)
+{
+   for (auto i = indices.crbegin(); i != indices.crend(); ++i)
+      v.erase(v.begin()+*i);
+}
+
+std::vector<item> make_items(std::size_t size)
+{
+   std::vector<item> items(size);
+   for (std::size_t i = 0; i != size; ++i)
+      items[i] = {double(i) * 20, 20, i, nullptr};
+   return items;
+}
+
+indices_type random_indices(std::size_t size, std::size_t count, std::mt19937& rng)
+{
+   indices_type all(size);
+   std::iota(all.begin(), all.end(), 0);
+   std::shuffle(all.begin(), all.end(), rng);
+   indices_type indices(all.begin(), all.begin() + count);
+   std::sort(indices.begin(), indices.end());
+   return indices;
+}
+
+template <typename F>
+double time_ms(F f)
+{
+   auto start = std::chrono::steady_clock::now();
+   f();
+   auto stop = std::chrono::steady_clock::now();
+   return std::chrono::duration<double, std::milli>(stop - start).count();
+}
+
+int main()
+{
+   std::mt19937 rng{1234};
+   std::size_t const sizes[] = {1000, 10000, 100000};
+   double const fractions[] = {0.01, 0.1, 0.5};
+
+   std::printf("%-8s %8s %8s %12s %12s %12s\n"
+      , "op", "size", "count", "old (ms)", "new (ms)", "speedup");
+
+   bool ok = true;
+   for (auto size : sizes)
+   {
+      for (auto fraction : fractions)
+      {
+         auto count = std::size_t(size * fraction);
+         auto indices = random_indices(size, count, rng);
+         auto pos = std::size_t(rng() % (size + 1));
+
+         // Move
+         {
+            auto a = make_items(size);
+            auto b = a;
+            auto t_old = time_ms([&]{ old_move_indices(a, pos, indices); });
+            auto t_new = time_ms([&]{ move_indices(b, pos, indices); });
+            ok = ok && a == b;
+            std::printf("%-8s %8zu %8zu %12.3f %12.3f %11.1fx\n"
+               , "move", size, count, t_old, t_new, t_old / t_new);
+         }
+
+         // Erase
+         {
+            auto a = make_items(size);
+            auto b = a;
+            auto t_old = time_ms([&]{ old_erase_indices(a, indices); });
+            auto t_new = time_ms([&]{ erase_indices(b, indices); });
+            ok = ok && a == b;
+            std::printf("%-8s %8zu %8zu %12.3f %12.3f %11.1fx\n"
+               , "erase", size, count, t_old, t_new, t_old / t_new);
+         }
+      }
+   }
+
+   if (!ok)
+      std::printf("Error: the old and new results differ\n");
+   return ok? 0 : 1;
+}
@@ -6,6 +6,8 @@
 #include <elements.hpp>
 #include <algorithm>
 #include <random>
+#include <string>
+#include <vector>
 
 using namespace cycfi::elements;
 using cycfi::artist::rgba;
@@ -142,6 +144,30 @@ auto make_dynamic_menu(char const* title, menu_position pos)
    return popup;
 }
 
+auto make_list_menu(char const* title, menu_position pos)
+{
+   auto popup  = button_menu(title, pos);
+
+   // A large menu. Only the visible items are composed. Type to filter
+   // the items by prefix.
+   std::vector<std::string> items;
+   for (int i = 0; i != 10000; ++i)
+      items.push_back("Item " + std::to_string(i));
+
+   popup.menu(
+      list_menu(
+         [](std::size_t index, std::string_view item)
+         {
+            // This will be called when an item is selected
+         },
+         items,
+         {250, 300}
+      )
+   );
+
+   return popup;
+}
+
 auto make_menus(view& view_)
 {
    return
@@ -150,6 +176,7 @@ auto make_menus(view& view_)
             hmin_size(300, make_selection_menu()),
             margin_top(20, make_popup_menu("Dropdown Menu", menu_position::bottom_right)),
             margin_top(20, make_dynamic_menu("Dynamic Menu", menu_position::bottom_right)),
+            margin_top(20, make_list_menu("List Menu", menu_position::bottom_right)),
             margin_top(20, scroller(image{"deep_space.jpg"})),
             margin_top(20, make_popup_menu("Dropup Menu", menu_position::top_right))
          )
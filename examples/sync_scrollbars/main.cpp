@@ -42,13 +42,11 @@ int main(int argc, char* argv[])
    // Scrollers
    auto scr = vscroller(margin({20, 20, 20, 20}, hold(l)));
    auto scr2 = vscroller(margin({20, 20, 20, 20}, hold(l2)));
-   // Second scrollers will follow first scroller position
-   scr.on_scroll = [&](point p)
-   {
-      scr2.set_position(p);
-      view_.layout();
-      view_.refresh();
-   };
+
+   // Both scrollers share the same scroll position
+   auto group = std::make_shared<scroll_group>();
+   scr.group(group);
+   scr2.group(group);
 
    view_.content(
       htile(
@@ -32,7 +32,11 @@ auto make_button(std::string text, color c, Label label, view& view_)
 {
    static int i = 1;
    std::string orig{label->get_text().data(), label->get_text().size()};
-   auto tt = tooltip(toggle_button("Option " + std::to_string(i++), 1.0f, c), make_tip(text));
+   // The tip is composed lazily, only when it is about to be shown
+   auto tt = tooltip(
+      toggle_button("Option " + std::to_string(i++), 1.0f, c)
+    , [text]{ return make_tip(text); }
+   );
    tt.on_hover =
       [label, text, &view_, orig](bool visible)
       {
@@ -23,6 +23,7 @@
 #include "SkCanvas.h"
 #include "SkSurface.h"
 
+#include <algorithm>
 #include <map>
 #include <string>
 
@@ -85,6 +86,8 @@ namespace cycfi { namespace elements
       std::uint32_t              _click_time = 0;     // Mouse button click tracking
       std::uint32_t              _click_count = 0;    // Mouse clicks count
       std::uint32_t              _scroll_time = 0;    // Scroll acceleration tracking
+      float                      _scroll_accel = 1;   // Scroll acceleration
+      point                      _scroll_dir;         // Last scroll direction
       point                      _cursor_position;    // Current cursor position
       key_map                    _keys;               // The key map
       int                        _modifiers = 0;      // the latest modifiers
@@ -98,6 +101,11 @@ namespace cycfi { namespace elements
       cairo_t*                   _cr;                 // The current cairo context
 
       std::unique_ptr<drop_info> _drop_info;          // For drag and drop
+
+      std::string                _text;               // Text commits not yet delivered
+      int                        _text_modifiers = 0; // Modifiers of the first commit
+      guint                      _text_source = 0;    // The idle source delivering _text
+      bool                       _in_filter = false;  // Filtering a key press
    };
 
    struct platform_access
@@ -119,6 +127,8 @@ namespace cycfi { namespace elements
 
    host_view::~host_view()
    {
+      if (_text_source)
+         g_source_remove(_text_source);
       _widget = nullptr;
    }
 
@@ -133,6 +143,24 @@ namespace cycfi { namespace elements
          return *reinterpret_cast<base_view*>(user_data);
       }
 
+      // Delivers the pending text commits as a single text event
+      void flush_text(base_view& view)
+      {
+         auto* host_view_h = platform_access::get_host_view(view);
+         if (host_view_h->_text_source)
+         {
+            g_source_remove(host_view_h->_text_source);
+            host_view_h->_text_source = 0;
+         }
+
+         if (host_view_h->_text.empty())
+            return;
+
+         auto text = std::move(host_view_h->_text);
+         host_view_h->_text.clear();
+         view.text({codepoint(text.c_str()), host_view_h->_text_modifiers, text});
+      }
+
       gboolean on_draw(GtkWidget* /*widget*/, cairo_t* cr, gpointer user_data)
       {
          auto& view = get(user_data);
@@ -297,6 +325,7 @@ namespace cycfi { namespace elements
       gboolean on_button(GtkWidget* /* widget */, GdkEventButton* event, gpointer user_data)
       {
          auto& view = get(user_data);
+         flush_text(view);
          mouse_button btn;
          if (get_button(event, btn, platform_access::get_host_view(view)))
             view.click(btn);
@@ -344,27 +373,31 @@ namespace cycfi { namespace elements
       {
          auto& base_view = get(user_data);
          auto* host_view_h = platform_access::get_host_view(base_view);
-         auto elapsed = std::max<float>(10.0f, event->time - host_view_h->_scroll_time);
-         static constexpr float _1s = 100;
-         host_view_h->_scroll_time = event->time;
+
+         // Each wheel notch scrolls by a fixed step. The scroller smooths
+         // out the motion, frame by frame. Consecutive notches in the same
+         // direction accelerate, same as in the Windows host.
+         static constexpr float wheel_step = 3;
+         static constexpr float accel_factor = 1.3;
+         static constexpr float max_accel = 100;
+         static constexpr std::uint32_t accel_reset_ms = 250;
 
          float dx = 0;
          float dy = 0;
-         float step = _1s / elapsed;
 
          switch (event->direction)
          {
             case GDK_SCROLL_UP:
-               dy = step;
+               dy = wheel_step;
                break;
             case GDK_SCROLL_DOWN:
-               dy = -step;
+               dy = -wheel_step;
                break;
             case GDK_SCROLL_LEFT:
-               dx = step;
+               dx = wheel_step;
                break;
             case GDK_SCROLL_RIGHT:
-               dx = -step;
+               dx = -wheel_step;
                break;
             case GDK_SCROLL_SMOOTH:
                dx = event->delta_x;
@@ -374,6 +407,22 @@ namespace cycfi { namespace elements
                break;
          }
 
+         if (event->direction != GDK_SCROLL_SMOOTH)
+         {
+            auto& accel = host_view_h->_scroll_accel;
+            auto& prev_dir = host_view_h->_scroll_dir;
+            bool reset_accel =
+               (event->time - host_view_h->_scroll_time) > accel_reset_ms ||
+               (prev_dir.x > 0) != (dx > 0) ||
+               (prev_dir.y > 0) != (dy > 0)
+               ;
+            accel = reset_accel? 1 : std::min(accel * accel_factor, max_accel);
+            prev_dir = {dx, dy};
+            dx *= accel;
+            dy *= accel;
+         }
+         host_view_h->_scroll_time = event->time;
+
          base_view.scroll(
             {dx, dy},
             {float(event->x), float(event->y)}
@@ -417,12 +466,41 @@ namespace cycfi { namespace elements
    // Defined in key.cpp
    key_code translate_key(unsigned key);
 
+   // Text committed while a key press is filtered is delivered at once,
+   // before the key itself, as before. Text committed outside of key
+   // handling (e.g. by an input method or a scanner, in bursts) is
+   // coalesced until the main loop is idle (before the next frame is
+   // drawn), then delivered as a single text event. Pending text is
+   // delivered before any other text, key, click, or change of focus, to
+   // keep the order of events.
+   static gboolean on_text_idle(gpointer user_data)
+   {
+      auto& base_view = get(user_data);
+      platform_access::get_host_view(base_view)->_text_source = 0;
+      flush_text(base_view);
+      return G_SOURCE_REMOVE;
+   }
+
    static void on_text_entry(GtkIMContext* /* context */, const gchar* str, gpointer user_data)
    {
       auto& base_view = get(user_data);
       auto* host_view_h = platform_access::get_host_view(base_view);
-      auto cp = codepoint(str);
-      base_view.text({cp, host_view_h->_modifiers});
+      if (host_view_h->_in_filter)
+      {
+         flush_text(base_view);
+         base_view.text({codepoint(str), host_view_h->_modifiers, str});
+         return;
+      }
+
+      if (host_view_h->_text.empty())
+         host_view_h->_text_modifiers = host_view_h->_modifiers;
+      host_view_h->_text += str;
+
+      if (!host_view_h->_text_source)
+      {
+         host_view_h->_text_source =
+            g_idle_add_full(G_PRIORITY_HIGH_IDLE, on_text_idle, user_data, nullptr);
+      }
    }
 
    int get_mods(int state)
@@ -466,12 +544,19 @@ namespace cycfi { namespace elements
    {
       auto& base_view = get(user_data);
       auto* host_view_h = platform_access::get_host_view(base_view);
-      gtk_im_context_filter_keypress(host_view_h->_im_context, event);
-
       int modifiers = get_mods(event->state);
-      auto const action = event->type == GDK_KEY_PRESS? key_action::press : key_action::release;
       host_view_h->_modifiers = modifiers;
 
+      // Text committed by the key is delivered before the key. Pending
+      // text is delivered before a key press that is not text.
+      host_view_h->_in_filter = true;
+      bool is_text = gtk_im_context_filter_keypress(host_view_h->_im_context, event);
+      host_view_h->_in_filter = false;
+      if (!is_text && event->type == GDK_KEY_PRESS && !event->is_modifier)
+         flush_text(base_view);
+
+      auto const action = event->type == GDK_KEY_PRESS? key_action::press : key_action::release;
+
       // We don't want the shift key handled when obtaining the keyval,
       // so we do this again here, instead of relying on event->keyval
       guint keyval = 0;
@@ -494,6 +579,7 @@ namespace cycfi { namespace elements
    void on_focus(GtkWidget* /* widget */, GdkEventFocus* event, gpointer user_data)
    {
       auto& base_view = get(user_data);
+      flush_text(base_view);
       if (event->in)
          base_view.begin_focus();
       else
@@ -563,7 +649,7 @@ namespace cycfi { namespace elements
                paths += *i;
             }
 
-            host_view_h->_drop_info->data["text/uri-list"] = paths;
+            host_view_h->_drop_info->data["text/uri-list"] = std::move(paths);
             success = base_view.drop(*host_view_h->_drop_info);
             g_strfreev(uris);
          }
@@ -774,6 +860,60 @@ namespace cycfi { namespace elements
       gtk_clipboard_set_text(clip, text.data(), text.size());
    }
 
+   namespace
+   {
+      void on_clipboard_text(GtkClipboard* /* clip */, gchar const* text, gpointer user_data)
+      {
+         // The text is delivered as is, without a copy
+         std::unique_ptr<clipboard_function> f{static_cast<clipboard_function*>(user_data)};
+         (*f)(text? std::string_view{text} : std::string_view{});
+      }
+
+      void get_clipboard_text(
+         GtkClipboard* /* clip */, GtkSelectionData* selection
+       , guint /* info */, gpointer user_data)
+      {
+         auto text = static_cast<payload_data*>(user_data)->text();
+         gtk_selection_data_set_text(selection, text.data(), text.size());
+      }
+
+      void clear_clipboard_text(GtkClipboard* /* clip */, gpointer user_data)
+      {
+         delete static_cast<payload_data*>(user_data);
+      }
+   }
+
+   void request_clipboard(clipboard_function f)
+   {
+      // Unlike gtk_clipboard_wait_for_text, gtk_clipboard_request_text
+      // does not block while the clipboard owner converts its data.
+      GtkClipboard* clip = gtk_clipboard_get(GDK_SELECTION_CLIPBOARD);
+      gtk_clipboard_request_text(clip, on_clipboard_text, new clipboard_function{std::move(f)});
+   }
+
+   void provide_clipboard(payload_data data)
+   {
+      GtkClipboard* clip = gtk_clipboard_get(GDK_SELECTION_CLIPBOARD);
+      GtkTargetList* list = gtk_target_list_new(nullptr, 0);
+      gtk_target_list_add_text_targets(list, 0);
+
+      gint num_targets = 0;
+      GtkTargetEntry* targets = gtk_target_table_new_from_list(list, &num_targets);
+
+      // The data is converted to text only in get_clipboard_text, when the
+      // clipboard is pasted, and is deleted when the clipboard is cleared.
+      auto data_ptr = new payload_data{std::move(data)};
+      if (!gtk_clipboard_set_with_data(
+         clip, targets, num_targets
+       , get_clipboard_text, clear_clipboard_text, data_ptr))
+      {
+         delete data_ptr;
+      }
+
+      gtk_target_table_free(targets, num_targets);
+      gtk_target_list_unref(list);
+   }
+
    void set_cursor(cursor_type type)
    {
       switch (type)
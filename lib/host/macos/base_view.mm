@@ -674,22 +674,30 @@ using skia_context = std::unique_ptr<sk_app::WindowContext>;
    auto pos = [sender draggingLocation];
    pos = [self convertPoint : pos fromView : nil];
 
+   // Only check if there are file URLs. The URLs themselves are read from
+   // the pasteboard lazily, only when they are actually needed (e.g. when
+   // the drop is accepted), not on every dragging update.
    NSPasteboard* pasteboard = [sender draggingPasteboard];
    NSDictionary* options = @{NSPasteboardURLReadingFileURLsOnlyKey:@YES};
-   NSArray* urls = [pasteboard   readObjectsForClasses:@[[NSURL class]]
-                                 options:options];
-   const NSUInteger count = [urls count];
-   if (count)
+   if ([pasteboard canReadObjectForClasses:@[[NSURL class]] options:options])
    {
-      std::string paths;
       info->where = ph::point{float(pos.x), float(pos.y)};
-      for (NSUInteger i = 0; i < count; ++i)
-      {
-         if (i != 0)
-            paths += "\n";
-         paths += std::string("file://") + [urls[i] fileSystemRepresentation];
-      }
-      info->data["text/uri-list"] = paths;
+      info->data["text/uri-list"] = ph::payload_data{
+         [pasteboard, options]()
+         {
+            NSArray* urls = [pasteboard   readObjectsForClasses:@[[NSURL class]]
+                                          options:options];
+            std::string paths;
+            const NSUInteger count = [urls count];
+            for (NSUInteger i = 0; i < count; ++i)
+            {
+               if (i != 0)
+                  paths += "\n";
+               paths += std::string("file://") + [urls[i] fileSystemRepresentation];
+            }
+            return ph::payload_buffer{std::move(paths)};
+         }
+      };
    }
 }
 
@@ -860,6 +868,17 @@ namespace cycfi { namespace elements
                     forType : NSPasteboardTypeString];
    }
 
+   void request_clipboard(clipboard_function f)
+   {
+      // The clipboard is read synchronously on this platform
+      f(clipboard());
+   }
+
+   void provide_clipboard(payload_data data)
+   {
+      clipboard(data.text());
+   }
+
    void set_cursor(cursor_type type)
    {
       switch (type)
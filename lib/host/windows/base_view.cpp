@@ -735,6 +735,17 @@ namespace cycfi { namespace elements
       CloseClipboard();
    }
 
+   void request_clipboard(clipboard_function f)
+   {
+      // The clipboard is read synchronously on this platform
+      f(clipboard());
+   }
+
+   void provide_clipboard(payload_data data)
+   {
+      clipboard(data.text());
+   }
+
    void set_cursor(cursor_type type)
    {
       struct cursors
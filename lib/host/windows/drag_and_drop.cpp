@@ -86,6 +86,7 @@ STDMETHODIMP DropTarget::DragLeave()
 {
    if (_drop_valid)
       _vptr->track_drop(_drop_info, cursor_tracking::leaving);
+   _drop_info.data.clear();
    return S_OK;
 }
 
@@ -96,6 +97,7 @@ STDMETHODIMP DropTarget::Drop(IDataObject* data_obj, DWORD key_state, POINTL pt,
       _drop_info.where = get_point(pt);
       _vptr->drop(_drop_info);
    }
+   _drop_info.data.clear();
    return S_OK;
 }
 
@@ -110,40 +112,61 @@ namespace cycfi::elements
    std::wstring utf8_decode(std::string const& str);
 }
 
-void DropTarget::makeDropInfo(IDataObject* data_obj)
+namespace
 {
-   using cycfi::elements::utf8_encode;
+   std::string get_uri_list(IDataObject* data_obj)
+   {
+      using cycfi::elements::utf8_encode;
 
-   // Retrieve file paths from IDataObject
-   FORMATETC fmt = { CF_HDROP, nullptr, DVASPECT_CONTENT, -1, TYMED_HGLOBAL };
-   STGMEDIUM stg_medium;
+      // Retrieve file paths from IDataObject
+      FORMATETC fmt = { CF_HDROP, nullptr, DVASPECT_CONTENT, -1, TYMED_HGLOBAL };
+      STGMEDIUM stg_medium;
 
-   _drop_valid = false;
-   if (SUCCEEDED(data_obj->GetData(&fmt, &stg_medium)))
-   {
-      HDROP drop = static_cast<HDROP>(GlobalLock(stg_medium.hGlobal));
-      if (UINT num_files = DragQueryFile(drop, 0xFFFFFFFF, nullptr, 0))
+      std::string paths;
+      if (SUCCEEDED(data_obj->GetData(&fmt, &stg_medium)))
       {
-         std::string paths;
-         for (UINT i = 0; i < num_files; ++i)
+         HDROP drop = static_cast<HDROP>(GlobalLock(stg_medium.hGlobal));
+         if (UINT num_files = DragQueryFile(drop, 0xFFFFFFFF, nullptr, 0))
          {
-            WCHAR path[MAX_PATH];
-            if (UINT length = DragQueryFileW(drop, i, path, MAX_PATH))
+            for (UINT i = 0; i < num_files; ++i)
             {
-               if (i != 0)
-                  paths += "\n";
-               std::wstring wpath(&path[0], length);
-               paths += std::string("file://") + utf8_encode(wpath);
-               _drop_valid = true;
+               WCHAR path[MAX_PATH];
+               if (UINT length = DragQueryFileW(drop, i, path, MAX_PATH))
+               {
+                  if (!paths.empty())
+                     paths += "\n";
+                  std::wstring wpath(&path[0], length);
+                  paths += std::string("file://") + utf8_encode(wpath);
+               }
             }
          }
 
-         if (_drop_valid)
-            _drop_info.data["text/uri-list"] = paths;
+         GlobalUnlock(stg_medium.hGlobal);
+         ReleaseStgMedium(&stg_medium);
       }
+      return paths;
+   }
+}
 
-      GlobalUnlock(stg_medium.hGlobal);
-      ReleaseStgMedium(&stg_medium);
+void DropTarget::makeDropInfo(IDataObject* data_obj)
+{
+   using cycfi::elements::payload_data;
+   using cycfi::elements::payload_buffer;
+
+   // Only check if there are file paths. The file paths themselves are
+   // extracted lazily, only when they are actually needed (e.g. when the
+   // drop is accepted), not while the drop is merely being tracked.
+   FORMATETC fmt = { CF_HDROP, nullptr, DVASPECT_CONTENT, -1, TYMED_HGLOBAL };
+   _drop_valid = data_obj->QueryGetData(&fmt) == S_OK;
+   _drop_info.data.clear();
+
+   if (_drop_valid)
+   {
+      data_obj->AddRef();
+      std::shared_ptr<IDataObject> obj{data_obj, [](IDataObject* p) { p->Release(); }};
+      _drop_info.data["text/uri-list"] = payload_data{
+         [obj]() { return payload_buffer{get_uri_list(obj.get())}; }
+      };
    }
 }
 
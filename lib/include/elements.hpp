@@ -11,5 +11,6 @@
 #include <elements/view.hpp>
 #include <elements/element.hpp>
 #include <elements/model.hpp>
+#include <elements/collection_model.hpp>
 
 #endif
\ No newline at end of file
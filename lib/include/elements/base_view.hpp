@@ -9,6 +9,7 @@
 #include <utility>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <cstdint>
 #include <functional>
 
@@ -81,11 +82,18 @@ namespace cycfi { namespace elements
 
    ////////////////////////////////////////////////////////////////////////////
    // Text info
+   //
+   // A text event may carry a whole string (e.g. an input method commit,
+   // or consecutive commits coalesced by the host). codepoint is then the
+   // first codepoint of text. If text is empty, the text is codepoint.
+   // Text typed with a key press is delivered before the key, as its own
+   // event. Only commits made outside of key handling are coalesced.
    ////////////////////////////////////////////////////////////////////////////
    struct text_info
    {
-      uint32_t codepoint;
-      int      modifiers;
+      uint32_t          codepoint;
+      int               modifiers;
+      std::string_view  text = {};     // UTF-8
    };
 
    ////////////////////////////////////////////////////////////////////////////
@@ -281,6 +289,47 @@ namespace cycfi { namespace elements
       int               modifiers;
    };
 
+   ////////////////////////////////////////////////////////////////////////////
+   // Shortcut key
+   ////////////////////////////////////////////////////////////////////////////
+   struct shortcut_key
+   {
+                  shortcut_key(key_code key_, int modifiers_)
+                  : key(key_)
+                  , modifiers(modifiers_)
+                  {
+                     if (modifiers & mod_action)
+#if defined(__APPLE__)
+                        modifiers |= mod_command;
+#else
+                        modifiers |= mod_control;
+#endif
+                  }
+
+                  shortcut_key() = default;
+
+      bool        matches(key_info const& k) const;
+
+      key_code    key = key_code::unknown;
+      int         modifiers = 0; // same as modifiers in key_info
+   };
+
+   inline bool shortcut_key::matches(key_info const& k) const
+   {
+      // Shift is ignored for keys that are shifted on some keyboards
+      int mask = 0xF;
+      switch (key)
+      {
+         case key_code::minus:
+         case key_code::equal:
+            mask &= ~mod_shift;
+            break;
+         default:
+            break;
+      }
+      return (k.key == key) && ((k.modifiers & mask) == (modifiers & mask));
+   }
+
    struct drop_info
    {
       payload           data;
@@ -361,6 +410,15 @@ namespace cycfi { namespace elements
    std::string clipboard();
    void clipboard(std::string_view text);
 
+   // Asynchronous clipboard access. request_clipboard returns right away.
+   // The text is delivered later, on the UI thread, in a single call.
+   // provide_clipboard places data in the clipboard that is converted to
+   // text only when it is pasted.
+   using clipboard_function = std::function<void(std::string_view text)>;
+
+   void request_clipboard(clipboard_function f);
+   void provide_clipboard(payload_data data);
+
    ////////////////////////////////////////////////////////////////////////////
    // The Cursor
    enum class cursor_type
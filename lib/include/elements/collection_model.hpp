@@ -0,0 +1,284 @@
+/*=================================================================================================
+   Copyright (c) 2016-2023 Joel de Guzman
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=================================================================================================*/
+#if !defined(ELEMENTS_COLLECTION_MODEL_OCTOBER_18_2026)
+#define ELEMENTS_COLLECTION_MODEL_OCTOBER_18_2026
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace cycfi::elements
+{
+   //==============================================================================================
+   /** @class collection_model
+    *
+    * The `collection_model` class holds a sequence of items that is linked to one or more user
+    * interface elements, typically lists. Like `model`, the data is modified through the member
+    * functions of the `collection_model`, which tell the linked elements what changed: items
+    * inserted, erased, moved or changed, or the whole collection reset. A user interface
+    * element is linked by supplying functions via `on_insert`, `on_erase`, `on_move`,
+    * `on_change` and `on_reset`.\n\n
+    *
+    * The events are fine-grained, so that linked elements can update only what is affected.
+    * Example:
+    * @code
+    *    collection_model<std::string> names;
+    *    names.push_back("Alice");        // on_insert(0, 1)
+    *    names.set(0, "Bob");             // on_change(0, 1)
+    *    names.erase(0);                  // on_erase(0, 1)
+    * @endcode
+    *
+    * @tparam T The type of the items.
+    */
+   //==============================================================================================
+   template <typename T>
+   class collection_model
+   {
+   public:
+
+      using value_type = T;
+      using container_type = std::vector<T>;
+      using const_iterator = typename container_type::const_iterator;
+      using indices_type = std::vector<std::size_t>;
+
+      using range_function = std::function<void(std::size_t pos, std::size_t num_items)>;
+      using move_function = std::function<void(std::size_t pos, indices_type const& indices)>;
+      using reset_function = std::function<void()>;
+
+                              collection_model() = default;
+                              collection_model(container_type items);
+
+                              collection_model(collection_model const&) = delete;
+      collection_model&       operator=(collection_model const&) = delete;
+
+      std::size_t             size() const                        { return _items.size(); }
+      bool                    empty() const                       { return _items.empty(); }
+      T const&                operator[](std::size_t i) const     { return _items[i]; }
+      const_iterator          begin() const                       { return _items.begin(); }
+      const_iterator          end() const                         { return _items.end(); }
+      container_type const&   items() const                       { return _items; }
+
+      void                    assign(container_type items);
+      void                    insert(std::size_t pos, T item);
+      template <typename Iter>
+      void                    insert(std::size_t pos, Iter first, Iter last);
+      void                    push_back(T item);
+      void                    erase(std::size_t pos, std::size_t num_items = 1);
+      void                    move(std::size_t pos, indices_type const& indices);
+      void                    set(std::size_t i, T item);
+      template <typename F>
+      void                    modify(std::size_t i, F&& f);
+      void                    clear();
+
+      void                    on_insert(range_function f);
+      void                    on_erase(range_function f);
+      void                    on_move(move_function f);
+      void                    on_change(range_function f);
+      void                    on_reset(reset_function f);
+
+   private:
+
+      template <typename F>
+      static void             chain(F& f, F next);
+
+      container_type          _items;
+      range_function          _insert;
+      range_function          _erase;
+      move_function           _move;
+      range_function          _change;
+      reset_function          _reset;
+   };
+
+   //==============================================================================================
+   // Inlines
+   //==============================================================================================
+
+   /** @brief Construct a `collection_model` with the given items.
+    */
+   template <typename T>
+   inline collection_model<T>::collection_model(container_type items)
+    : _items(std::move(items))
+   {}
+
+   /** @brief Replace all the items. The linked elements are reset.
+    */
+   template <typename T>
+   inline void collection_model<T>::assign(container_type items)
+   {
+      _items = std::move(items);
+      if (_reset)
+         _reset();
+   }
+
+   /** @brief Insert an item before `pos`.
+    */
+   template <typename T>
+   inline void collection_model<T>::insert(std::size_t pos, T item)
+   {
+      _items.insert(_items.begin() + pos, std::move(item));
+      if (_insert)
+         _insert(pos, 1);
+   }
+
+   /** @brief Insert the items in [first, last) before `pos`, as a single range.
+    */
+   template <typename T>
+   template <typename Iter>
+   inline void collection_model<T>::insert(std::size_t pos, Iter first, Iter last)
+   {
+      auto num_items = std::size_t(std::distance(first, last));
+      _items.insert(_items.begin() + pos, first, last);
+      if (_insert && num_items)
+         _insert(pos, num_items);
+   }
+
+   /** @brief Append an item.
+    */
+   template <typename T>
+   inline void collection_model<T>::push_back(T item)
+   {
+      insert(_items.size(), std::move(item));
+   }
+
+   /** @brief Erase `num_items` items starting at `pos`.
+    */
+   template <typename T>
+   inline void collection_model<T>::erase(std::size_t pos, std::size_t num_items)
+   {
+      num_items = std::min(num_items, _items.size() - pos);
+      _items.erase(_items.begin() + pos, _items.begin() + pos + num_items);
+      if (_erase && num_items)
+         _erase(pos, num_items);
+   }
+
+   /** @brief Move the items at the given `indices` before `pos` (an index before the move).
+    *         The moved items keep their relative order. The indices should be sorted in
+    *         ascending order, with no duplicates.
+    */
+   template <typename T>
+   inline void collection_model<T>::move(std::size_t pos, indices_type const& indices)
+   {
+      if (indices.empty())
+         return;
+
+      pos = std::min(pos, _items.size());
+      container_type moved, rest;
+      moved.reserve(indices.size());
+      rest.reserve(_items.size() - indices.size());
+
+      std::size_t dest = 0;
+      auto ix = indices.begin();
+      for (std::size_t i = 0; i != _items.size(); ++i)
+      {
+         if (ix != indices.end() && *ix == i)
+         {
+            moved.push_back(std::move(_items[i]));
+            ++ix;
+         }
+         else
+         {
+            if (i < pos)
+               ++dest;
+            rest.push_back(std::move(_items[i]));
+         }
+      }
+
+      rest.insert(rest.begin() + dest
+       , std::make_move_iterator(moved.begin()), std::make_move_iterator(moved.end()));
+      _items = std::move(rest);
+
+      if (_move)
+         _move(pos, indices);
+   }
+
+   /** @brief Replace the item at index `i`.
+    */
+   template <typename T>
+   inline void collection_model<T>::set(std::size_t i, T item)
+   {
+      _items[i] = std::move(item);
+      if (_change)
+         _change(i, 1);
+   }
+
+   /** @brief Modify the item at index `i` in place, by calling `f(item)`.
+    */
+   template <typename T>
+   template <typename F>
+   inline void collection_model<T>::modify(std::size_t i, F&& f)
+   {
+      f(_items[i]);
+      if (_change)
+         _change(i, 1);
+   }
+
+   /** @brief Erase all items. The linked elements are reset.
+    */
+   template <typename T>
+   inline void collection_model<T>::clear()
+   {
+      assign({});
+   }
+
+   /**
+    * @brief Set the functions to be invoked when items are inserted, erased, moved or changed,
+    *        or when the whole collection is reset. Like `model::on_update`, these may be called
+    *        multiple times, and each supplied function will be called sequentially, in a
+    *        first-come, first-served order.
+    */
+   template <typename T>
+   inline void collection_model<T>::on_insert(range_function f)
+   {
+      chain(_insert, std::move(f));
+   }
+
+   template <typename T>
+   inline void collection_model<T>::on_erase(range_function f)
+   {
+      chain(_erase, std::move(f));
+   }
+
+   template <typename T>
+   inline void collection_model<T>::on_move(move_function f)
+   {
+      chain(_move, std::move(f));
+   }
+
+   template <typename T>
+   inline void collection_model<T>::on_change(range_function f)
+   {
+      chain(_change, std::move(f));
+   }
+
+   template <typename T>
+   inline void collection_model<T>::on_reset(reset_function f)
+   {
+      chain(_reset, std::move(f));
+   }
+
+   template <typename T>
+   template <typename F>
+   inline void collection_model<T>::chain(F& f, F next)
+   {
+      if (f)
+      {
+         f =
+            [prev_f = f, next](auto const&... args)
+            {
+               prev_f(args...);
+               next(args...);
+            };
+      }
+      else
+      {
+         f = std::move(next);
+      }
+   }
+}
+
+#endif
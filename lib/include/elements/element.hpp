@@ -9,6 +9,7 @@
 #include <elements/element/align.hpp>
 #include <elements/element/button.hpp>
 #include <elements/element/child_window.hpp>
+#include <elements/element/collection_list.hpp>
 #include <elements/element/composite.hpp>
 #include <elements/element/dial.hpp>
 #include <elements/element/drag_and_drop.hpp>
@@ -16,6 +17,7 @@
 #include <elements/element/floating.hpp>
 #include <elements/element/flow.hpp>
 #include <elements/element/grid.hpp>
+#include <elements/element/grid_list.hpp>
 #include <elements/element/image.hpp>
 #include <elements/element/indirect.hpp>
 #include <elements/element/label.hpp>
@@ -30,6 +32,7 @@
 #include <elements/element/range_slider.hpp>
 #include <elements/element/size.hpp>
 #include <elements/element/slider.hpp>
+#include <elements/element/styled_text.hpp>
 #include <elements/element/text.hpp>
 #include <elements/element/thumbwheel.hpp>
 #include <elements/element/tile.hpp>
@@ -68,7 +68,7 @@ namespace cycfi { namespace elements
 
       bool              state(bool val);
       void              tracking(bool val);
-      void              hilite(bool val);
+      bool              hilite(bool val);
 
    private:
 
@@ -137,8 +137,8 @@ namespace cycfi { namespace elements
    template <typename Base>
    inline void basic_toggle_button<Base>::drag(context const& ctx, mouse_button btn)
    {
-      this->hilite(ctx.bounds.includes(btn.pos));
-      if (this->state(!_current_state ^ ctx.bounds.includes(btn.pos)))
+      bool hilite_changed = this->hilite(ctx.bounds.includes(btn.pos));
+      if (this->state(!_current_state ^ ctx.bounds.includes(btn.pos)) || hilite_changed)
          ctx.view.refresh(ctx);
    }
 
@@ -10,27 +10,58 @@
 #include <elements/element/tracker.hpp>
 #include <elements/element/traversal.hpp>
 #include <elements/element/button.hpp>
+#include <artist/image.hpp>
 
 namespace cycfi { namespace elements
 {
    ////////////////////////////////////////////////////////////////////////////
    // Child window: Are floating elements that may overlap and move to front
    // when clicked.
+   //
+   // A cached child window is rendered into its own cached layer while it
+   // is being moved. Moving the window then only composites the cached
+   // layer at the new position, and the layers below are redrawn only
+   // where the window uncovered them.
+   //
+   // A child window that fully covers its bounds (e.g. no rounded corners
+   // or shadows) can be marked opaque. The layers below it are then not
+   // drawn where it covers them.
    ////////////////////////////////////////////////////////////////////////////
    class child_window_element : public floating_element
    {
    public:
+                           child_window_element(rect bounds, bool cached = false)
+                            : floating_element(bounds)
+                            , _cached(cached)
+                           {}
 
-      using floating_element::floating_element;
-
+      void                 draw(context const& ctx) override;
       bool                 click(context const& ctx, mouse_button btn) override;
+      bool                 is_opaque() const override { return _opaque; }
+
+      bool                 cached() const             { return _cached; }
+      void                 cached(bool cached_)       { _cached = cached_; }
+      void                 opaque(bool opaque_)       { _opaque = opaque_; }
+
+      void                 begin_move();
+      void                 end_move();
+      bool                 is_moving() const          { return _moving; }
+
+   private:
+
+      void                 draw_layer(context const& ctx);
+
+      bool                 _cached;
+      bool                 _opaque = false;
+      bool                 _moving = false;
+      artist::image_ptr    _layer;
    };
 
    template <typename Subject>
    inline proxy<remove_cvref_t<Subject>, child_window_element>
-   child_window(rect bounds, Subject&& subject)
+   child_window(rect bounds, Subject&& subject, bool cached = false)
    {
-      return {std::forward<Subject>(subject), bounds};
+      return {std::forward<Subject>(subject), bounds, cached};
    }
 
    ////////////////////////////////////////////////////////////////////////////
@@ -55,7 +86,9 @@ namespace cycfi { namespace elements
       element*             hit_test(context const& ctx, point p, bool leaf, bool control) override;
       bool                 click(context const& ctx, mouse_button btn) override;
       void                 drag(context const& ctx, mouse_button btn) override;
+      void                 begin_tracking(context const& ctx, tracker_info& track_info) override;
       void                 keep_tracking(context const& ctx, tracker_info& track_info) override;
+      void                 end_tracking(context const& ctx, tracker_info& track_info) override;
    };
 
    template <typename Subject>
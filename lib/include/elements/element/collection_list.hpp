@@ -0,0 +1,156 @@
+/*=============================================================================
+   Copyright (c) 2016-2023 Joel de Guzman
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(ELEMENTS_COLLECTION_LIST_OCTOBER_18_2026)
+#define ELEMENTS_COLLECTION_LIST_OCTOBER_18_2026
+
+#include <elements/element/list.hpp>
+#include <elements/collection_model.hpp>
+#include <elements/view.hpp>
+#include <memory>
+#include <numeric>
+
+namespace cycfi { namespace elements
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // This cell composer takes the number of list elements from a
+   // collection_model. The composer does not own the model, which must
+   // outlive it.
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename T, typename Base = cell_composer>
+   class collection_cell_composer : public Base
+   {
+   public:
+
+      using base_type = collection_cell_composer<T, Base>;
+      using model_type = collection_model<T>;
+
+                              template <typename... Rest>
+                              collection_cell_composer(model_type& model_, Rest&& ...rest)
+                               : Base(std::forward<Rest>(rest)...)
+                               , _model(model_)
+                              {}
+
+      std::size_t             size() const override { return _model.size(); }
+      void                    resize(size_t /* s */) override {}   // The size follows the model
+      model_type&             model() const { return _model; }
+
+   private:
+
+      model_type&             _model;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // collection_composer given a collection_model and a compose function,
+   // f(item, index), returning the element for the item at index.
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename T, typename F>
+   inline auto collection_composer(collection_model<T>& model, F&& compose)
+   {
+      auto f =
+         [&model, compose = std::forward<F>(compose)](std::size_t index)
+         {
+            return compose(model[index], index);
+         };
+
+      using ftype = decltype(f);
+      using return_type =
+         vfixed_derived_limits_cell_composer<
+            collection_cell_composer<T,
+               function_cell_composer<ftype>
+            >
+         >;
+      return share(return_type{model, std::move(f)});
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Link a list to a collection_model. The changes to the model are
+   // forwarded to the list as incremental requests: only the inserted and
+   // changed rows are composed again (when visible), and only the rows
+   // past the first change are moved. The list queues the requests, and
+   // the view lays out and refreshes the list once for all the changes
+   // made before the next UI event loop iteration, applying them as a
+   // single list transaction. The list also applies the queued requests
+   // as soon as its cells are accessed, so an event dispatched before
+   // then never composes a row with a stale index. The list is held
+   // weakly.
+   ////////////////////////////////////////////////////////////////////////////
+   template <typename T>
+   inline void link(collection_model<T>& model, std::shared_ptr<list> list_, view& view_)
+   {
+      std::weak_ptr<list> wp = list_;
+      auto pending = std::make_shared<bool>(false);
+
+      auto request =
+         [wp, pending, &view_](auto f)
+         {
+            auto lp = wp.lock();
+            if (!lp)
+               return;
+            f(*lp);
+
+            // Lay out and refresh once for all the changes
+            if (!*pending)
+            {
+               *pending = true;
+               view_.post(
+                  [wp, pending, &view_]()
+                  {
+                     *pending = false;
+                     if (auto lp = wp.lock())
+                     {
+                        view_.layout(*lp);
+                        view_.refresh(*lp);
+                     }
+                  }
+               );
+            }
+         };
+
+      model.on_insert(
+         [request](std::size_t pos, std::size_t num_items)
+         {
+            request([=](list& l) { l.insert(pos, num_items); });
+         }
+      );
+
+      model.on_erase(
+         [request](std::size_t pos, std::size_t num_items)
+         {
+            request(
+               [=](list& l)
+               {
+                  list::indices_type indices(num_items);
+                  std::iota(indices.begin(), indices.end(), pos);
+                  l.erase(indices);
+               }
+            );
+         }
+      );
+
+      model.on_move(
+         [request](std::size_t pos, list::indices_type const& indices)
+         {
+            request([&](list& l) { l.move(pos, indices); });
+         }
+      );
+
+      model.on_change(
+         [request](std::size_t pos, std::size_t num_items)
+         {
+            request([=](list& l) { l.update(pos, pos + num_items); });
+         }
+      );
+
+      model.on_reset(
+         [request]()
+         {
+            request([](list& l) { l.update(); });
+         }
+      );
+   }
+}}
+
+#endif
@@ -145,6 +145,9 @@ namespace cycfi { namespace elements
       std::size_t             size() const override;
       element&                at(std::size_t ix) const override;
 
+      std::size_t             first() const { return _first; }
+      std::size_t             last() const { return _last; }
+
    private:
 
       std::size_t             _first;
@@ -33,14 +33,27 @@ namespace cycfi { namespace elements
 
       bool                    is_tracking() const     { return _is_tracking; }
       mime_types const&       get_mime_types() const  { return _mime_types; }
-      mime_types&             get_mime_types()        { return _mime_types; }
+      mime_types&             get_mime_types();
 
    private:
 
+      mime_set const&         get_mime_ids();
+
       bool                    _is_tracking = false;
       mime_types              _mime_types;
+      mime_set                _mime_ids;
+      bool                    _mime_ids_valid = false;
+      drop_base const*        _self = nullptr;
+      std::string             _self_key;     // Our address, as a pseudo MIME type
    };
 
+   inline drop_base::mime_types& drop_base::get_mime_types()
+   {
+      // The caller may modify the MIME types. Rebuild the IDs when needed.
+      _mime_ids_valid = false;
+      return _mime_types;
+   }
+
    class drop_box_base : public drop_base
    {
    public:
@@ -87,6 +100,7 @@ namespace cycfi { namespace elements
       on_delete_function      on_erase = [](indices_type const&){};
       on_select_function      on_select = [](indices_type const&, std::size_t){};
 
+      // `indices` are the selected items, sorted in ascending order
       int                     insertion_pos() const { return _insertion_pos; }
       void                    move(indices_type const& indices);
       void                    erase(indices_type const& indices);
@@ -94,6 +108,10 @@ namespace cycfi { namespace elements
    public:
 
       int                     _insertion_pos = -1;
+
+   private:
+
+      rect                    _indicator;
    };
 
    namespace detail
@@ -138,6 +156,7 @@ namespace cycfi { namespace elements
 
       bool                    _selected = false;
       drag_image_ptr          _drag_image;
+      drop_info               _drop_info;
    };
 
    template <typename Subject>
@@ -27,6 +27,10 @@ namespace cycfi { namespace elements
       rect                    bounds() const { return _bounds; }
       void                    bounds(rect bounds_) { _bounds = bounds_; }
 
+      // An opaque floating element fully covers its bounds. The layers
+      // below it are not drawn there.
+      virtual bool            is_opaque() const { return false; }
+
    private:
 
       rect                    _bounds;
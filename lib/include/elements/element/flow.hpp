@@ -8,10 +8,78 @@
 
 #include <elements/element/composite.hpp>
 #include <elements/element/tile.hpp>
+#include <elements/element/list.hpp>
 #include <functional>
+#include <vector>
 
 namespace cycfi { namespace elements
 {
+   ////////////////////////////////////////////////////////////////////////////
+   // Flow Lines
+   //
+   // Breaks a sequence of items into lines, given the width of each item.
+   // The item widths are cached. Only the items marked by reflow (and the
+   // items added since the last measure) are measured again. Items inserted
+   // or erased in the middle should be reported through insert and erase,
+   // which shift the cached widths, so that only the inserted items are
+   // measured. Otherwise, all the items past the first added or removed
+   // item are measured again. Breaking
+   // restarts from the line before the first changed item, and stops as
+   // soon as the new lines fall in step with the old lines past the last
+   // changed item.
+   ////////////////////////////////////////////////////////////////////////////
+   class flow_lines
+   {
+   public:
+
+      static constexpr auto npos = std::size_t(-1);
+
+      using measure_function = std::function<float(std::size_t index)>;
+
+      // The lines [first, last) replace the old lines [first, old_last).
+      // The lines past these are the same as before, shifted by
+      // (last - old_last).
+      struct change
+      {
+         std::size_t          first = 0;
+         std::size_t          last = 0;
+         std::size_t          old_last = 0;
+
+         bool                 empty() const { return first == last && first == old_last; }
+      };
+
+      void                    measure(std::size_t size, measure_function f);
+      change                  break_lines(float width);
+      void                    reflow(std::size_t first = 0, std::size_t last = npos);
+      bool                    needs_reflow() const;
+      void                    insert(std::size_t pos, std::size_t n);
+      void                    erase(std::size_t pos, std::size_t n);
+
+      std::size_t             size() const                     { return _widths.size(); }
+      std::size_t             num_lines() const                { return _breaks.size(); }
+      std::size_t             first(std::size_t line) const    { return _breaks[line]; }
+      std::size_t             last(std::size_t line) const;
+      std::size_t             line_of(std::size_t index) const;
+      float                   min_width() const                { return _min_width; }
+
+   private:
+
+      std::vector<float>      _widths;
+      std::vector<std::size_t> _breaks;
+      std::size_t             _size = 0;     // Number of items at the last break
+      float                   _width = -1;
+      float                   _min_width = 0;
+
+      // Items [_dirty_first, _dirty_last) need to be measured
+      std::size_t             _dirty_first = 0;
+      std::size_t             _dirty_last = npos;
+
+      // Items [_changed_first, _changed_last) were measured since the last
+      // break_lines
+      std::size_t             _changed_first = npos;
+      std::size_t             _changed_last = 0;
+   };
+
    ////////////////////////////////////////////////////////////////////////////
    // Flow Element
    ////////////////////////////////////////////////////////////////////////////
@@ -19,6 +87,8 @@ namespace cycfi { namespace elements
    {
    public:
 
+      static constexpr auto npos = flow_lines::npos;
+
       void                    break_lines(
                                  std::vector<element_ptr>& rows
                                , basic_context const& ctx
@@ -28,17 +98,41 @@ namespace cycfi { namespace elements
       virtual float           width_of(size_t index, basic_context const& ctx) const;
       virtual element_ptr     make_row(size_t first, size_t last);
 
-      void                    reflow()                { _reflow = true; }
-      bool                    needs_reflow() const    { return _reflow; }
-      void                    reflow_done()           { _reflow = false; }
+      void                    reflow(std::size_t first = 0, std::size_t last = npos);
+      bool                    needs_reflow() const;
+      void                    items_inserted(std::size_t pos, std::size_t n)  { _lines.insert(pos, n); }
+      void                    items_erased(std::size_t pos, std::size_t n)    { _lines.erase(pos, n); }
+      float                   min_width() const       { return _lines.min_width(); }
+
+      [[deprecated("Not needed anymore. The flow keeps track of what needs reflowing.")]]
+      void                    reflow_done()           {}
 
    private:
 
-      bool                    _reflow = true;
+      flow_lines              _lines;
    };
 
    using flow_composite = vector_composite<flowable_container>;
 
+   // The default row made by flowable_container::make_row. The row limits
+   // are cached until the row is invalidated. Rows are reused by the flow
+   // element as long as their range of items does not change.
+   class flow_row : public range_composite<htile_element>
+   {
+   public:
+
+      using base_type = range_composite<htile_element>;
+      using base_type::base_type;
+
+      view_limits             limits(basic_context const& ctx) const override;
+      void                    invalidate()            { _limits_valid = false; }
+
+   private:
+
+      mutable view_limits     _limits;
+      mutable bool            _limits_valid = false;
+   };
+
    class flow_element : public vector_composite<vtile_element>
    {
    public:
@@ -55,12 +149,160 @@ namespace cycfi { namespace elements
    private:
 
       flowable_container&     _flowable;
+      mutable view_limits     _limits = {{0, 0}, {full_extent, full_extent}};
    };
 
    inline auto flow(flowable_container& flowable_)
    {
       return flow_element{flowable_};
    }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Flow Composer
+   //
+   // Supplies the items of a flow_list. The items are measured through
+   // width_of and height_of, without composing them. Items are composed
+   // only when the line they are in becomes visible.
+   ////////////////////////////////////////////////////////////////////////////
+   class flow_composer
+   {
+   public:
+
+      virtual                 ~flow_composer() = default;
+
+      virtual std::size_t     size() const = 0;
+      virtual element_ptr     compose(std::size_t index) = 0;
+      virtual float           width_of(std::size_t index, basic_context const& ctx) const = 0;
+      virtual float           height_of(std::size_t index, basic_context const& ctx) const = 0;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Flow Cell Composer
+   //
+   // Presents the lines of a flow_composer as the cells of a list. Each
+   // cell is a line of items, as broken by flow_lines.
+   ////////////////////////////////////////////////////////////////////////////
+   class flow_cell_composer : public cell_composer
+   {
+   public:
+
+      using flow_composer_ptr = std::shared_ptr<flow_composer>;
+      static constexpr auto npos = flow_lines::npos;
+
+                              flow_cell_composer(flow_composer_ptr composer)
+                               : _composer(composer)
+                              {}
+
+      std::size_t             size() const override;
+      void                    resize(std::size_t /* s */) override {}
+      element_ptr             compose(std::size_t line) override;
+      limits                  secondary_axis_limits(basic_context const& ctx) const override;
+      float                   main_axis_size(std::size_t line, basic_context const& ctx) const override;
+
+      flow_lines::change      break_lines(basic_context const& ctx, float width);
+      void                    reflow(std::size_t first = 0, std::size_t last = npos);
+      void                    items_inserted(std::size_t pos, std::size_t n);
+      void                    items_erased(std::size_t pos, std::size_t n);
+      flow_composer&          composer() const        { return *_composer; }
+
+   private:
+
+      void                    measure(basic_context const& ctx) const;
+
+      flow_composer_ptr       _composer;
+      mutable flow_lines      _lines;
+      mutable std::vector<float> _heights;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Flow List
+   //
+   // A virtualized flow. The lines are the cells of a list, and only the
+   // visible lines are composed. When the width or the items change, only
+   // the lines from the first changed item are replaced. Call reflow with
+   // the range of changed items, and items_inserted or items_erased when
+   // items are inserted or erased (followed by a layout).
+   ////////////////////////////////////////////////////////////////////////////
+   class flow_list : public list
+   {
+   public:
+
+      using flow_composer_ptr = std::shared_ptr<flow_cell_composer>;
+      static constexpr auto npos = flow_lines::npos;
+
+                              flow_list(flow_composer_ptr composer, bool manage_externally = true)
+                               : list(composer, manage_externally)
+                               , _flow_composer(composer)
+                              {}
+
+      void                    layout(context const& ctx) override;
+      void                    reflow(std::size_t first = 0, std::size_t last = npos);
+      void                    items_inserted(std::size_t pos, std::size_t n);
+      void                    items_erased(std::size_t pos, std::size_t n);
+
+   private:
+
+      flow_composer_ptr       _flow_composer;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Inlines
+   ////////////////////////////////////////////////////////////////////////////
+   inline bool flow_lines::needs_reflow() const
+   {
+      return _dirty_first < _dirty_last;
+   }
+
+   inline std::size_t flow_lines::last(std::size_t line) const
+   {
+      return (line + 1 < _breaks.size())? _breaks[line + 1] : _widths.size();
+   }
+
+   inline void flowable_container::reflow(std::size_t first, std::size_t last)
+   {
+      _lines.reflow(first, last);
+   }
+
+   inline bool flowable_container::needs_reflow() const
+   {
+      return _lines.needs_reflow() || _lines.size() != size();
+   }
+
+   inline void flow_cell_composer::reflow(std::size_t first, std::size_t last)
+   {
+      _lines.reflow(first, last);
+   }
+
+   inline void flow_cell_composer::items_inserted(std::size_t pos, std::size_t n)
+   {
+      _lines.insert(pos, n);
+      _heights.insert(_heights.begin() + std::min(pos, _heights.size()), n, 0.0f);
+   }
+
+   inline void flow_cell_composer::items_erased(std::size_t pos, std::size_t n)
+   {
+      _lines.erase(pos, n);
+      if (pos < _heights.size())
+      {
+         n = std::min(n, _heights.size() - pos);
+         _heights.erase(_heights.begin() + pos, _heights.begin() + pos + n);
+      }
+   }
+
+   inline void flow_list::reflow(std::size_t first, std::size_t last)
+   {
+      _flow_composer->reflow(first, last);
+   }
+
+   inline void flow_list::items_inserted(std::size_t pos, std::size_t n)
+   {
+      _flow_composer->items_inserted(pos, n);
+   }
+
+   inline void flow_list::items_erased(std::size_t pos, std::size_t n)
+   {
+      _flow_composer->items_erased(pos, n);
+   }
 }}
 
 #endif
@@ -13,6 +13,7 @@
 #include <elements/element/margin.hpp>
 #include <elements/element/tile.hpp>
 #include <elements/support/theme.hpp>
+#include <elements/support/text_utils.hpp>
 #include <infra/support.hpp>
 #include <infra/string_view.hpp>
 #include <utility>
@@ -49,6 +50,26 @@ namespace cycfi { namespace elements
       virtual label_alignment get_label_alignment() const;
       virtual rect            get_margin() const;
       virtual float           get_corner_radius() const;
+
+   private:
+
+      // The measured text and icon sizes are cached, and measured again
+      // only when the text, icon, size or theme change. The theme snapshot
+      // covers the fonts (see theme_ptr).
+      struct measure_cache
+      {
+         theme_ptr            theme;
+         std::string          text;
+         std::uint32_t        icon = 0;
+         float                font_size = -1;
+         float                icon_font_size = -1;
+         point                text_size;
+         point                icon_size;
+      };
+
+      measure_cache const&    measure(canvas& cnv) const;
+
+      mutable measure_cache   _measure;
    };
 
    template <typename Base>
@@ -57,7 +78,7 @@ namespace cycfi { namespace elements
       using text_type = std::string_view;
       using base_type = basic_button_styler_base<typename Base::base_type>;
 
-                              basic_button_styler_base(std::string text)
+                              basic_button_styler_base(label_text text)
                                : _text(std::move(text))
                               {}
 
@@ -66,7 +87,7 @@ namespace cycfi { namespace elements
 
    private:
 
-      std::string             _text;
+      label_text              _text;
    };
 
    template <typename Base>
@@ -522,7 +543,7 @@ namespace cycfi { namespace elements
    template <typename Base>
    inline void basic_button_styler_base<Base>::set_text(string_view text)
    {
-      _text = std::string(text);
+      _text.assign(text);
    }
 
    template <typename Base>
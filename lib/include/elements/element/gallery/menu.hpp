@@ -8,6 +8,7 @@
 
 #include <elements/element/indirect.hpp>
 #include <elements/element/menu.hpp>
+#include <elements/element/port.hpp>
 #include <elements/element/label.hpp>
 #include <elements/element/align.hpp>
 #include <elements/element/size.hpp>
@@ -246,6 +247,83 @@ namespace cycfi { namespace elements
 
       return selection_menu(on_select, init_list_menu_selector{list}, text_align, on_item);
    }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // List Menu
+   //
+   // A menu for a large number of items (e.g. font pickers, device lists).
+   // Only the visible items are composed. Typing filters the items by
+   // prefix, backspace removes the last typed character.
+   ////////////////////////////////////////////////////////////////////////////
+   inline auto list_menu(
+      std::function<void(std::size_t index, string_view item)> on_select
+    , menu_selector const& items
+    , point size = {300, 300}
+    , float text_align = 0.0f // align left
+   )
+   {
+      auto labels = std::make_shared<std::vector<std::string>>();
+      labels->reserve(items.size());
+      for (std::size_t i = 0; i != items.size(); ++i)
+         labels->emplace_back(items[i]);
+
+      auto composer = std::make_shared<list_menu_composer>(
+         labels->size()
+       , [labels](std::size_t index) -> string_view
+         {
+            return (*labels)[index];
+         }
+       , [labels, text_align](std::size_t index) -> element_ptr
+         {
+            return share(menu_item_text((*labels)[index], text_align));
+         }
+      );
+
+      composer->on_select =
+         [labels, on_select](std::size_t index)
+         {
+            on_select(index, (*labels)[index]);
+         };
+
+      auto list_ = share(vlist{composer});
+      return layer(
+         fixed_size(size, basic_list_menu(vscroller(hold(list_)), composer, list_)),
+         panel{}
+      );
+   }
+
+   template <typename Sequence>
+   inline auto list_menu(
+      std::function<void(std::size_t index, string_view item)> on_select
+    , Sequence const& seq
+    , point size = {300, 300}
+    , float text_align = 0.0f // align left
+    , typename std::enable_if<!std::is_base_of<menu_selector, Sequence>::value>::type* = nullptr
+   )
+   {
+      struct seq_menu_selector : menu_selector
+      {
+         seq_menu_selector(Sequence const& seq_)
+          : _seq(seq_)
+         {}
+
+         std::size_t
+         size() const override
+         {
+            return std::size(_seq);
+         }
+
+         string_view
+         operator[](std::size_t index) const override
+         {
+            return _seq[index];
+         }
+
+         Sequence const& _seq;
+      };
+
+      return list_menu(on_select, seq_menu_selector{seq}, size, text_align);
+   }
 }}
 
 #endif
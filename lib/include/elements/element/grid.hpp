@@ -8,6 +8,7 @@
 
 #include <elements/view.hpp>
 #include <elements/element/composite.hpp>
+#include <vector>
 
 namespace cycfi { namespace elements
 {
@@ -20,6 +21,12 @@ namespace cycfi { namespace elements
       virtual std::size_t     grid_size() const = 0;
       virtual float           grid_coord(std::size_t i) const = 0;
       virtual std::size_t     num_spans() const = 0;
+
+   protected:
+
+      using grid_index_vector = std::vector<std::size_t>;
+
+      std::size_t             compute_spans(grid_index_vector& grid_index) const;
    };
 
    template <typename Base>
@@ -81,10 +88,23 @@ namespace cycfi { namespace elements
       rect                    bounds_of(context const& ctx, std::size_t index) const override;
       std::size_t             num_spans() const override { return _num_spans; }
 
+      hit_info                hit_element(context const& ctx, point p, bool control) const override;
+      void                    for_each_visible(
+                                 context const& ctx
+                               , for_each_callback f
+                               , bool reverse = false
+                              ) const override;
+
    private:
 
       std::vector<float>      _positions;
-      mutable std::size_t     _num_spans;
+      mutable std::size_t     _num_spans = 0;
+
+      // The grid index of each element and the limits are cached for the
+      // view's current layout pass (see view::layout_pass).
+      mutable grid_index_vector _grid_index;
+      mutable view_limits     _limits;
+      mutable std::size_t     _limits_pass = 0;
    };
 
    using vgrid_composite = vector_composite<
@@ -130,10 +150,23 @@ namespace cycfi { namespace elements
       rect                    bounds_of(context const& ctx, std::size_t index) const override;
       std::size_t             num_spans() const override { return _num_spans; }
 
+      hit_info                hit_element(context const& ctx, point p, bool control) const override;
+      void                    for_each_visible(
+                                 context const& ctx
+                               , for_each_callback f
+                               , bool reverse = false
+                              ) const override;
+
    private:
 
       std::vector<float>      _positions;
-      mutable std::size_t     _num_spans;
+      mutable std::size_t     _num_spans = 0;
+
+      // The grid index of each element and the limits are cached for the
+      // view's current layout pass (see view::layout_pass).
+      mutable grid_index_vector _grid_index;
+      mutable view_limits     _limits;
+      mutable std::size_t     _limits_pass = 0;
    };
 
    using hgrid_composite = vector_composite<
@@ -0,0 +1,114 @@
+/*=============================================================================
+   Copyright (c) 2016-2023 Joel de Guzman
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(ELEMENTS_GRID_LIST_OCTOBER_18_2026)
+#define ELEMENTS_GRID_LIST_OCTOBER_18_2026
+
+#include <elements/element/list.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace cycfi { namespace elements
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // The recycling cell composer abstract class
+   //
+   // A cell composer that can reuse the element of a cell that scrolled out
+   // of view for another cell. recompose is given the recycled element and
+   // returns the element for the cell at index (typically the same element,
+   // updated to show the new item).
+   ////////////////////////////////////////////////////////////////////////////
+   class recycling_cell_composer : public cell_composer
+   {
+   public:
+
+      virtual element_ptr     recompose(std::size_t index, element_ptr recycled) = 0;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Grid List (gallery view)
+   //
+   // Wraps uniformly sized cells into rows, based on the available width.
+   // The composer's secondary_axis_limits give the minimum and maximum cell
+   // width. There are as many columns as cells of minimum width fit in the
+   // available width, and the cells are widened to fill the row (up to the
+   // maximum cell width). The cell height is the composer's main_axis_size
+   // of the first cell, or, if an aspect ratio (height / width) is given,
+   // the cell width times the aspect ratio.
+   //
+   // Cell positions are computed from the index, without querying the
+   // cells. Only the visible cells are composed. If manage_externally is
+   // true, cells that scroll out of view are released (or recycled, if the
+   // composer is a recycling_cell_composer).
+   ////////////////////////////////////////////////////////////////////////////
+   class grid_list : public composite_base
+   {
+   public:
+
+      using composer_ptr = std::shared_ptr<cell_composer>;
+
+                                 grid_list(
+                                    composer_ptr composer
+                                  , float aspect_ratio = 0
+                                  , bool manage_externally = true
+                                 );
+
+      view_limits                limits(basic_context const& ctx) const override;
+      void                       draw(context const& ctx) override;
+      void                       layout(context const& ctx) override;
+
+      void                       update();
+      void                       resize(std::size_t n);
+      bool                       manage_externally() const { return _manage_externally; }
+
+      std::size_t                columns() const { return _columns; }
+      std::size_t                rows() const;
+      std::size_t                index_of(context const& ctx, point p) const;
+      rect                       bounds_of(context const& ctx, std::size_t ix) const override;
+
+      std::size_t                size() const override;
+      element&                   at(std::size_t ix) const override;
+
+      void                       for_each_visible(
+                                    context const& ctx
+                                  , for_each_callback f
+                                  , bool reverse = false
+                                 ) const override;
+
+   private:
+
+      struct cell_info
+      {
+         element_ptr             elem_ptr;
+         int                     layout_id = -1;
+      };
+
+      using cells_map = std::unordered_map<std::size_t, cell_info>;
+      using elements_vector = std::vector<element_ptr>;
+
+      void                       visible_range(
+                                    context const& ctx
+                                  , rect const& visible
+                                  , std::size_t& first
+                                  , std::size_t& last
+                                 ) const;
+      void                       release(std::size_t first, std::size_t last);
+
+      composer_ptr               _composer;
+      recycling_cell_composer*   _recycler;
+      float                      _aspect_ratio;
+      bool                       _manage_externally;
+
+      std::size_t                _columns = 0;
+      float                      _cell_width = 0;
+      float                      _cell_height = 0;
+      int                        _layout_id = 0;
+
+      mutable cells_map          _cells;
+      mutable elements_vector    _recycled;
+   };
+}}
+
+#endif
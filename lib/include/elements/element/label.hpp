@@ -12,8 +12,11 @@
 #include <elements/element/traversal.hpp>
 #include <elements/support/theme.hpp>
 #include <elements/support/receiver.hpp>
+#include <elements/support/text_utils.hpp>
 #include <artist/font.hpp>
+#include <artist/text_layout.hpp>
 #include <infra/string_view.hpp>
+#include <memory>
 #include <string>
 
 namespace cycfi { namespace elements
@@ -43,9 +46,34 @@ namespace cycfi { namespace elements
       virtual color           get_font_color() const;
       virtual int             get_text_align() const;
 
+      // The label's text, as a label_text. The default makes one from
+      // get_text(). Labels that hold a label_text return it, so that the
+      // glyph run shares its storage instead of keeping a copy.
+      virtual label_text      get_label_text() const     { return label_text{get_text()}; }
+
    private:
 
+      // The text is shaped once into a glyph run that is used for both
+      // measuring and drawing. The run is made again only when the text or
+      // the font changes. When only the text changes, the font is reused.
+      // It is immutable, and may be shared by copies of the label.
+      struct glyph_run
+      {
+                              glyph_run(label_text text_, font_descr descr_, artist::font font_);
+
+         label_text           text;
+         font_descr           descr;
+         artist::font         font;
+         artist::text_layout  layout;
+         point                size;
+      };
+
+      using glyph_run_ptr = std::shared_ptr<glyph_run const>;
+
+      glyph_run const&        get_run(basic_context const& ctx) const;
+
       bool                    _is_enabled = true;
+      mutable glyph_run_ptr   _run;
    };
 
    template <typename Base>
@@ -54,16 +82,20 @@ namespace cycfi { namespace elements
       using text_type = std::string_view;
       using base_type = basic_label_base<typename Base::base_type>;
 
-                              basic_label_base(std::string text)
+                              basic_label_base(label_text text)
                                : _text(std::move(text))
                               {}
 
       text_type               get_text() const override           { return _text; }
-      void                    set_text(string_view text) override { _text = std::string(text); }
+      void                    set_text(string_view text) override { _text.assign(text); }
+      label_text              get_label_text() const override     { return _text; }
+
+                              template <typename T>
+      void                    set_number(T val)                   { _text.assign_number(val); }
 
    private:
 
-      std::string             _text;
+      label_text              _text;
    };
 
    template <typename Base>
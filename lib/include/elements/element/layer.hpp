@@ -8,9 +8,13 @@
 
 #include <elements/element/composite.hpp>
 #include <algorithm>
+#include <utility>
+#include <vector>
 
 namespace cycfi { namespace elements
 {
+   class floating_element;
+
    ////////////////////////////////////////////////////////////////////////////
    // Layer
    ////////////////////////////////////////////////////////////////////////////
@@ -30,8 +34,16 @@ namespace cycfi { namespace elements
 
    private:
 
+      // Each element, paired with the floating element (e.g. a child
+      // window, which may be opaque) found in it, if any. The pairs are
+      // made again only when the elements change.
+      using floating_vector = std::vector<std::pair<element const*, floating_element*>>;
+
       void                    focus_top(focus_request req);
+      floating_vector const&  floating() const;
+
       point                   _previous_size;
+      mutable floating_vector _floating;
    };
 
    using layer_composite = vector_composite<layer_element>;
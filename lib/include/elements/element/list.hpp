@@ -10,6 +10,7 @@
 #include <memory>
 #include <vector>
 #include <functional>
+#include <algorithm>
 #include <set>
 #include<iostream>
 
@@ -310,6 +311,7 @@ namespace cycfi { namespace elements
       void                       move(std::size_t pos, indices_type const& indices);
       void                       insert(std::size_t pos, std::size_t num_items);
       void                       erase(indices_type const& indices);
+      void                       update(std::size_t first, std::size_t last);
 
       rect                       bounds_of(context const& ctx, std::size_t ix) const override;
 
@@ -338,17 +340,38 @@ namespace cycfi { namespace elements
       virtual float              get_main_axis_end(const rect &r) const;
       virtual void               set_bounds(rect& r, float main_axis_start, cell_info &info) const;
       void                       set_bounds(context& ctx, float main_axis_start, cell_info &info) const;
+      void                       update_positions(std::size_t from) const;
+      void                       sync(basic_context const& ctx) const;
 
       using cells_vector = std::vector<cell_info>;
       mutable cells_vector       _cells;
 
    private:
 
-      void                       sync(basic_context const& ctx) const;
+      // move, insert, erase and update(first, last) are requests, queued
+      // in order and applied together, as a single transaction, at the
+      // next layout or draw. A full update discards the queued requests.
+      // The requests are also applied, without measuring the new cells, as
+      // soon as the cells are accessed (size, at, for_each_visible), so
+      // that the cells always follow the composer's items.
+      enum class request_type { move, insert, erase, update };
+
+      struct request_info
+      {
+         request_type            type;
+         std::size_t             pos = 0;
+         std::size_t             num_items = 0;
+         indices_type            indices;
+      };
+
+      using requests_vector = std::vector<request_info>;
+
+      void                       apply_requests() const;
       void                       update(basic_context const& ctx) const;
-      void                       move(basic_context const& ctx) const;
-      void                       insert(basic_context const& ctx) const;
-      void                       erase(basic_context const& ctx) const;
+      std::size_t                move(request_info const& r) const;
+      std::size_t                insert(request_info const& r) const;
+      std::size_t                erase(request_info const& r) const;
+      std::size_t                update(request_info const& r) const;
 
       composer_ptr               _composer;
       bool                       _manage_externally;
@@ -359,22 +382,11 @@ namespace cycfi { namespace elements
       mutable double             _main_axis_full_size = 0;
       mutable int                _layout_id = 0;
 
-      mutable bool               _update_request:1;
-      mutable bool               _move_request:1;
-      mutable bool               _insert_request:1;
-      mutable bool               _erase_request :1;
-
-      struct request_info
-      {
-         std::size_t                _move_pos;
-         std::vector<std::size_t>   _move_indices;
-         std::size_t                _insert_pos;
-         std::size_t                _insert_num_items;
-         std::vector<std::size_t>   _delete_indices;
-      };
+      static constexpr auto      no_change = std::size_t(-1);
 
-      using request_info_ptr = std::unique_ptr<request_info>;
-      mutable request_info_ptr      _request_info;
+      mutable bool               _update_request;
+      mutable requests_vector    _requests;
+      mutable std::size_t        _first_changed = no_change;
    };
 
    // The old name is deprecated
@@ -409,40 +421,99 @@ namespace cycfi { namespace elements
    using hdynamic_list [[deprecated("Use hlist instead.")]] = hlist;
 
    // Utility to move items in a vector `v` from given `indices` to a new position, `pos`.
+   // The moved items keep their relative order. Returns the index of the first moved
+   // item after the move. The moved items are at [returned index, returned index +
+   // indices.size()).
+   //
+   // This is done in a single pass over the vector, with only the moved items held in a
+   // temporary buffer. The unmoved items before `pos` are compacted towards the front, and
+   // the unmoved items at or after `pos` are compacted towards the back, leaving a gap that
+   // is then filled with the moved items.
    template <typename T>
-   inline void move_indices(std::vector<T>& v, std::size_t pos, std::vector<std::size_t> const& indices)
+   inline std::size_t move_indices(std::vector<T>& v, std::size_t pos, std::vector<std::size_t> const& indices)
    {
-      // Precondition: The indices should be validly pointing to items in vector `v`.
+      // Precondition: The indices should be validly pointing to items in vector `v`, and
+      // should be sorted in ascending order, with no duplicates.
+
+      if (indices.empty())
+         return std::min(pos, v.size());
+
+      pos = std::min(pos, v.size());
+      auto split = std::lower_bound(indices.begin(), indices.end(), pos);
 
-      // Reserve space for moved elements
       std::vector<T> to_move;
       to_move.reserve(indices.size());
 
-      // Create a copy of the elements to be moved and erase the elements
-      // from their original positions. Iterating in reverse, after this
-      // operation, `to_move` will contain the items in reverse order.
-      for (auto i = indices.crbegin(); i != indices.crend(); ++i)
+      // Items before `pos`: compact the unmoved items towards the front
+      std::size_t first = pos;
+      if (split != indices.begin())
       {
-         to_move.push_back(std::move(v[*i]));
-         v.erase(v.begin()+*i);
-         if (pos > *i)
-            --pos;
+         std::size_t dest = indices.front();
+         auto ix = indices.begin();
+         for (std::size_t i = indices.front(); i != pos; ++i)
+         {
+            if (ix != split && *ix == i)
+            {
+               to_move.push_back(std::move(v[i]));
+               ++ix;
+            }
+            else
+            {
+               v[dest++] = std::move(v[i]);
+            }
+         }
+         first = dest;
       }
 
-      // Determine the insert position
-      auto pos_i = v.begin() + std::min(pos, v.size());
+      // Items at or after `pos`: compact the unmoved items towards the back
+      if (split != indices.end())
+      {
+         auto num_after = std::size_t(indices.end() - split);
+         auto n = to_move.size();
+         to_move.resize(n + num_after);
+
+         std::size_t back = indices.back() + 1;
+         auto rx = indices.end();
+         auto m = to_move.size();
+         for (std::size_t i = indices.back() + 1; i-- != pos;)
+         {
+            if (rx != split && *(rx-1) == i)
+            {
+               to_move[--m] = std::move(v[i]);
+               --rx;
+            }
+            else
+            {
+               v[--back] = std::move(v[i]);
+            }
+         }
+      }
 
-      // Insert the elements at the new position in reverse order
-      v.insert(pos_i, to_move.crbegin(), to_move.crend());
+      // Fill the gap with the moved items
+      std::move(to_move.begin(), to_move.end(), v.begin() + first);
+      return first;
    }
 
-   // Utility to erase items in a vector `v` with given `indices`.
+   // Utility to erase items in a vector `v` with given `indices`. This is done in a single
+   // pass over the vector.
    template <typename T>
    inline void erase_indices(std::vector<T>& v, std::vector<std::size_t> const& indices)
    {
-      // Precondition: The indices should be validly pointing to items in vector `v`.
-      for (auto i = indices.crbegin(); i != indices.crend(); ++i)
-         v.erase(v.begin()+*i);
+      // Precondition: The indices should be validly pointing to items in vector `v`, and
+      // should be sorted in ascending order, with no duplicates.
+      if (indices.empty())
+         return;
+
+      std::size_t dest = indices.front();
+      auto ix = indices.begin();
+      for (std::size_t i = indices.front(); i != v.size(); ++i)
+      {
+         if (ix != indices.end() && *ix == i)
+            ++ix;
+         else
+            v[dest++] = std::move(v[i]);
+      }
+      v.erase(v.begin() + dest, v.end());
    }
 
    ////////////////////////////////////////////////////////////////////////////
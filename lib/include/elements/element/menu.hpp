@@ -10,8 +10,11 @@
 #include <elements/element/button.hpp>
 #include <elements/element/popup.hpp>
 #include <elements/element/selection.hpp>
+#include <elements/element/list.hpp>
 #include <elements/view.hpp>
 #include <infra/support.hpp>
+#include <string>
+#include <vector>
 
 namespace cycfi { namespace elements
 {
@@ -69,26 +72,6 @@ namespace cycfi { namespace elements
    ////////////////////////////////////////////////////////////////////////////
    // Menu Items
    ////////////////////////////////////////////////////////////////////////////
-   struct shortcut_key
-   {
-                  shortcut_key(key_code key_, int modifiers_)
-                  : key(key_)
-                  , modifiers(modifiers_)
-                  {
-                     if (modifiers & mod_action)
-#if defined(__APPLE__)
-                        modifiers |= mod_command;
-#else
-                        modifiers |= mod_control;
-#endif
-                  }
-
-                  shortcut_key() = default;
-
-      key_code    key = key_code::unknown;
-      int         modifiers = 0; // same as modifiers in key_info (see base_view.hpp)
-   };
-
    template <typename Derived>
    struct basic_menu_item_element_base : proxy_base
    {
@@ -143,6 +126,169 @@ namespace cycfi { namespace elements
    {
       _selected = state;
    }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Menu Item Index
+   //
+   // A sorted index of menu item labels for type-ahead search. The labels
+   // are folded to lower case and sorted once, when the index is built.
+   // Finding the items that start with a given prefix is then a pair of
+   // binary searches. If the new prefix extends the previous one (i.e. the
+   // user keeps on typing), only the range matched by the previous prefix
+   // is searched.
+   ////////////////////////////////////////////////////////////////////////////
+   class menu_item_index
+   {
+   public:
+
+      using indices_type = std::vector<std::size_t>;
+      using get_function = std::function<string_view(std::size_t index)>;
+
+      void                    build(std::size_t size, get_function get);
+      bool                    filter(string_view prefix);
+      string_view             prefix() const       { return _prefix; }
+      indices_type const&     matches() const      { return _matches; }
+
+   private:
+
+      struct key_entry
+      {
+         std::string          key;
+         std::size_t          index;
+      };
+
+      using keys_vector = std::vector<key_entry>;
+
+      keys_vector             _keys;
+      std::size_t             _first = 0;
+      std::size_t             _last = 0;
+      std::string             _prefix;
+      indices_type            _matches;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // List Menu
+   //
+   // A menu backed by a list, for menus with a large number of items. Only
+   // the visible items are composed. The selection is tracked by row, so
+   // up and down navigation does not have to search the items. Typing
+   // filters the items by prefix using a menu_item_index.
+   ////////////////////////////////////////////////////////////////////////////
+   class list_menu_composer : public cell_composer
+   {
+   public:
+
+      using get_function = menu_item_index::get_function;
+      using compose_function = std::function<element_ptr(std::size_t index)>;
+      using select_function = std::function<void(std::size_t index)>;
+
+                              list_menu_composer(
+                                 std::size_t size
+                               , get_function get
+                               , compose_function compose
+                              );
+
+      std::size_t             size() const override;
+      void                    resize(std::size_t s) override;
+      element_ptr             compose(std::size_t row) override;
+      limits                  secondary_axis_limits(basic_context const& ctx) const override;
+      float                   main_axis_size(std::size_t row, basic_context const& ctx) const override;
+
+      std::size_t             item(std::size_t row) const;
+      bool                    filter(string_view prefix);
+      string_view             filter() const       { return _index.prefix(); }
+
+      int                     selected() const     { return _selected; }
+      void                    select(int row)      { _selected = row; }
+
+      select_function         on_select;
+
+   private:
+
+      void                    get_limits(basic_context const& ctx) const;
+
+      menu_item_index         _index;
+      std::size_t             _num_items;
+      compose_function        _compose;
+      int                     _selected = -1;
+
+      mutable float           _main_axis_size = -1;
+      mutable limits          _secondary_axis_limits = {-1, full_extent};
+   };
+
+   class list_menu_item_element : public basic_menu_item_element
+   {
+   public:
+                              list_menu_item_element(list_menu_composer& composer, std::size_t row)
+                               : _composer(composer)
+                               , _row(row)
+                              {}
+
+      bool                    key(context const& ctx, key_info k) override;
+      bool                    cursor(context const& ctx, point p, cursor_tracking status) override;
+
+      bool                    is_selected() const override;
+      void                    select(bool state) override;
+
+   private:
+
+      list_menu_composer&     _composer;
+      std::size_t             _row;
+   };
+
+   class basic_list_menu_element : public proxy_base
+   {
+   public:
+
+      using composer_ptr = std::shared_ptr<list_menu_composer>;
+      using list_ptr = std::shared_ptr<list>;
+
+                              basic_list_menu_element(composer_ptr composer, list_ptr list_)
+                               : _composer(composer)
+                               , _list(list_)
+                              {}
+
+      view_limits             limits(basic_context const& ctx) const override;
+      bool                    key(context const& ctx, key_info k) override;
+      bool                    text(context const& ctx, text_info info) override;
+      bool                    wants_control() const override { return true; }
+      bool                    wants_focus() const override { return true; }
+
+      void                    filter(context const& ctx, string_view prefix);
+
+   private:
+
+      void                    select_next(context const& ctx, bool down);
+      void                    scroll_to_selected(context const& ctx);
+      void                    close(context const& ctx);
+
+      composer_ptr            _composer;
+      list_ptr                _list;
+   };
+
+   template <typename Subject>
+   inline proxy<remove_cvref_t<Subject>, basic_list_menu_element>
+   basic_list_menu(
+      Subject&& subject
+    , std::shared_ptr<list_menu_composer> composer
+    , std::shared_ptr<list> list_
+   )
+   {
+      return {std::forward<Subject>(subject), composer, list_};
+   }
+
+   inline bool list_menu_item_element::is_selected() const
+   {
+      return _composer.selected() == int(_row);
+   }
+
+   inline void list_menu_item_element::select(bool state)
+   {
+      if (state)
+         _composer.select(int(_row));
+      else if (is_selected())
+         _composer.select(-1);
+   }
 }}
 
 #endif
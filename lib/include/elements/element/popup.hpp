@@ -9,6 +9,7 @@
 #include <elements/element/floating.hpp>
 #include <elements/view.hpp>
 #include <infra/support.hpp>
+#include <vector>
 
 namespace cycfi { namespace elements
 {
@@ -67,7 +68,13 @@ namespace cycfi { namespace elements
 
    private:
 
+      void                    add_shortcuts(view& view_);
+      void                    remove_shortcuts(view& view_);
+
+      using shortcut_ids = std::vector<view::shortcut_id>;
+
       basic_button_menu*      _menu_button = nullptr;
+      shortcut_ids            _shortcuts;
    };
 
    template <typename Subject>
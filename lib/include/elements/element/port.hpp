@@ -9,6 +9,7 @@
 #include <elements/element/proxy.hpp>
 #include <infra/support.hpp>
 #include <memory>
+#include <vector>
 
 namespace cycfi { namespace elements
 {
@@ -160,6 +161,39 @@ namespace cycfi { namespace elements
       no_vscroll     = 1 << 2
    };
 
+   ////////////////////////////////////////////////////////////////////////////
+   // Scroll Group
+   //
+   // Scrollers in a scroll group share a single scroll position, for the
+   // axes they scroll. When one of them scrolls, the others follow. The
+   // group refreshes the areas of all its scrollers together, once, after
+   // the event (or frame) that moved them, however many of them moved.
+   ////////////////////////////////////////////////////////////////////////////
+   class scroll_group : public std::enable_shared_from_this<scroll_group>
+   {
+   public:
+
+      using bounds_ptr = std::shared_ptr<rect>;
+
+      point                   position() const              { return _position; }
+      void                    position(point p)             { _position = p; }
+
+      void                    track(bounds_ptr bounds);
+      void                    moved(view& view_);
+
+   private:
+
+      using bounds_vector = std::vector<std::weak_ptr<rect>>;
+
+      void                    flush(view& view_);
+
+      point                   _position;
+      bounds_vector           _members;         // Device bounds of the scrollers
+      bool                    _pending = false;
+   };
+
+   using scroll_group_ptr = std::shared_ptr<scroll_group>;
+
    // Base proxy class for views that are scrollable
    class scroller_base : public port_element, public scrollable
    {
@@ -187,6 +221,20 @@ namespace cycfi { namespace elements
       std::function<void(point p)> on_scroll = [](point){};
       void set_position(point p);
 
+      // Join a scroll group. The scroller's position is then the group's
+      // position, for the axes it scrolls.
+      void                    group(scroll_group_ptr group_)   { _group = group_; }
+      scroll_group_ptr        group() const                    { return _group; }
+
+      double                  halign() const override;
+      void                    halign(double val) override;
+      double                  valign() const override;
+      void                    valign(double val) override;
+
+      // Called once per frame while scrolling, with the distance the
+      // content moved in that frame (e.g. for blitting the scrolled area).
+      std::function<void(point delta)> on_scroll_delta = [](point){};
+
       struct scrollbar_info
       {
          double   pos;
@@ -215,8 +263,49 @@ namespace cycfi { namespace elements
          tracking_h
       };
 
+      // Kinetic scrolling. Scroll events accumulate into a velocity that
+      // the view's frame clock integrates into the scroll position, once
+      // per frame. The state is shared with the frame clock while
+      // scrolling, and is not shared by copies of the scroller.
+      struct kinetic_state
+      {
+         scroller_base*    owner = nullptr;
+         point             pending;          // Scroll input since the last frame
+         point             velocity;         // Pixels per second
+         point             range;            // Scrollable extent in pixels
+         rect              device_bounds;    // For refreshing the scroller
+         bool              running = false;
+      };
+
+      using kinetic_ptr = std::shared_ptr<kinetic_state>;
+
+      struct kinetic_holder
+      {
+                           kinetic_holder() = default;
+                           kinetic_holder(kinetic_holder const&) {}
+                           ~kinetic_holder() { if (ptr) ptr->owner = nullptr; }
+         kinetic_holder&   operator=(kinetic_holder const&) { return *this; }
+
+         kinetic_ptr       ptr;
+      };
+
+      // The device bounds tracked by the scroll group. Like the kinetic
+      // state, these are not shared by copies of the scroller.
+      struct group_bounds_holder
+      {
+                           group_bounds_holder() = default;
+                           group_bounds_holder(group_bounds_holder const&) {}
+         group_bounds_holder& operator=(group_bounds_holder const&) { return *this; }
+
+         scroll_group::bounds_ptr ptr;
+      };
+
       scrollbar_bounds  get_scrollbar_bounds(context const& ctx);
       bool              reposition(context const& ctx, point p);
+      bool              kinetic_step(view& view_, kinetic_state& k, double dt);
+      point             move_by(point dist, point range);
+      void              scrolled(view& view_, rect device_bounds);
+      void              scrolled(context const& ctx);
 
       bool              has_scrollbars() const { return !(_traits & no_scrollbars); }
       bool              allow_hscroll() const { return !(_traits & no_hscroll); }
@@ -225,6 +314,9 @@ namespace cycfi { namespace elements
       point             _offset;
       tracking_status   _tracking;
       int               _traits;
+      kinetic_holder    _kinetic;
+      scroll_group_ptr  _group;
+      group_bounds_holder _group_bounds;
    };
 
    template <typename Subject>
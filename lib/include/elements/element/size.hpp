@@ -9,6 +9,9 @@
 #include <elements/element/element.hpp>
 #include <elements/element/proxy.hpp>
 #include <infra/support.hpp>
+#include <artist/image.hpp>
+#include <artist/canvas.hpp>
+#include <cmath>
 #include <memory>
 
 namespace cycfi { namespace elements
@@ -618,6 +621,12 @@ namespace cycfi { namespace elements
 
    ////////////////////////////////////////////////////////////////////////////
    // Scaled
+   //
+   // In zoom mode (between begin_zoom and end_zoom), the subject is neither
+   // laid out nor drawn. Instead, a snapshot of the subject, rendered at the
+   // scale when zooming began, is drawn transformed to the current scale.
+   // The limits stay at the scale when zooming began. After end_zoom, the
+   // subject should be laid out again at the final scale.
    ////////////////////////////////////////////////////////////////////////////
    template <typename Subject>
    class scale_element : public proxy<Subject>
@@ -633,6 +642,8 @@ namespace cycfi { namespace elements
 
       view_limits             limits(basic_context const& ctx) const override;
       view_stretch            stretch() const override;
+      void                    draw(context const& ctx) override;
+      void                    layout(context const& ctx) override;
       void                    prepare_subject(context& ctx) override;
       void                    prepare_subject(context& ctx, point& p) override;
       void                    restore_subject(context& ctx) override;
@@ -640,9 +651,19 @@ namespace cycfi { namespace elements
       void                    scale(float scale_) { _scale = scale_; }
       float                   scale() const { return _scale; }
 
+      void                    begin_zoom();
+      void                    end_zoom();
+      bool                    is_zooming() const { return _zoom_scale > 0; }
+
    private:
 
+      float                   layout_scale() const { return is_zooming()? _zoom_scale : _scale; }
+      void                    draw_snapshot(context const& ctx);
+
       float                   _scale;
+      float                   _zoom_scale = 0;
+      artist::image_ptr       _snapshot;
+      rect                    _snapshot_bounds;
    };
 
    template <typename Subject>
@@ -656,11 +677,12 @@ namespace cycfi { namespace elements
    inline view_limits
    scale_element<Subject>::limits(basic_context const& ctx) const
    {
+      auto const scale_ = layout_scale();
       auto l = this->subject().limits(ctx);
-      l.min.x *= _scale;
-      l.min.y *= _scale;
-      l.max.x *= _scale;
-      l.max.y *= _scale;
+      l.min.x *= scale_;
+      l.min.y *= scale_;
+      l.max.x *= scale_;
+      l.max.y *= scale_;
       clamp_max(l.max.x, full_extent);
       clamp_max(l.max.y, full_extent);
       return l;
@@ -670,8 +692,84 @@ namespace cycfi { namespace elements
    inline view_stretch
    scale_element<Subject>::stretch() const
    {
+      auto const scale_ = layout_scale();
       auto s = this->subject().stretch();
-      return {s.x * _scale, s.y * _scale};
+      return {s.x * scale_, s.y * scale_};
+   }
+
+   template <typename Subject>
+   inline void scale_element<Subject>::begin_zoom()
+   {
+      if (!is_zooming())
+         _zoom_scale = _scale;
+   }
+
+   template <typename Subject>
+   inline void scale_element<Subject>::end_zoom()
+   {
+      _zoom_scale = 0;
+      _snapshot.reset();
+   }
+
+   template <typename Subject>
+   inline void scale_element<Subject>::layout(context const& ctx)
+   {
+      if (!is_zooming())
+         base_type::layout(ctx);
+   }
+
+   template <typename Subject>
+   inline void scale_element<Subject>::draw(context const& ctx)
+   {
+      if (is_zooming())
+         draw_snapshot(ctx);
+      else
+         base_type::draw(ctx);
+   }
+
+   template <typename Subject>
+   void scale_element<Subject>::draw_snapshot(context const& ctx)
+   {
+      if (!_snapshot)
+      {
+         // Render the subject at the scale when zooming began, in device
+         // pixels. Only the visible part of our bounds is rendered. The
+         // bounds can be much larger than the view (e.g. in a scroller).
+         auto const& bounds = ctx.bounds;
+         auto const clip_extent = ctx.canvas.clip_extent();
+         if (!intersects(bounds, clip_extent))
+            return;
+         _snapshot_bounds = intersection(bounds, clip_extent);
+
+         auto tl = ctx.canvas.user_to_device(bounds.top_left());
+         auto br = ctx.canvas.user_to_device(bounds.bottom_right());
+         auto device_scale = (br.x - tl.x) / bounds.width();
+         auto const& r = _snapshot_bounds;
+
+         _snapshot = std::make_shared<artist::image>(
+            extent{std::ceil(r.width() * device_scale), std::ceil(r.height() * device_scale)}
+         );
+
+         artist::offscreen_image offscr{*_snapshot};
+         canvas cnv{offscr.context()};
+         cnv.pre_scale(device_scale);
+         cnv.translate(-r.left, -r.top);
+
+         auto const scale_ = _scale;
+         _scale = _zoom_scale;
+         base_type::draw(context{ctx.view, cnv, this, bounds});
+         _scale = scale_;
+      }
+
+      // The subject is scaled about the origin. Going from the snapshot's
+      // scale to the current scale, the snapshot is scaled about the origin
+      // as well.
+      auto const f = _scale / _zoom_scale;
+      auto const& r = _snapshot_bounds;
+      ctx.canvas.draw(
+         *_snapshot
+       , rect{r.left * f, r.top * f, r.right * f, r.bottom * f}
+      );
    }
 
    template <typename Subject>
@@ -0,0 +1,163 @@
+/*=============================================================================
+   Copyright (c) 2016-2023 Joel de Guzman
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#if !defined(ELEMENTS_STYLED_TEXT_OCTOBER_18_2026)
+#define ELEMENTS_STYLED_TEXT_OCTOBER_18_2026
+
+#include <elements/element/text.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace cycfi::elements
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // Text Style
+   ////////////////////////////////////////////////////////////////////////////
+   struct text_style
+   {
+      color                   text_color = get_theme().text_box_font_color;
+      color                   background = {};  // Transparent: no background
+      bool                    bold = false;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Style Runs
+   //
+   // Run-length style spans over a text. Each run is given by the index of
+   // its first character and a style index. replace shifts the runs to
+   // follow an edit of the text: inserted text takes the style of the
+   // character before it.
+   ////////////////////////////////////////////////////////////////////////////
+   class style_runs
+   {
+   public:
+
+      using style_index = std::uint16_t;
+
+      void                    reset(std::size_t size, style_index style = 0);
+      void                    apply(std::size_t first, std::size_t last, style_index style);
+      void                    replace(std::size_t pos, std::size_t len, std::size_t new_len);
+
+      std::size_t             size() const               { return _size; }
+      std::size_t             num_runs() const           { return _runs.size(); }
+      style_index             style_at(std::size_t pos) const;
+
+                              // Calls f(first, last, style) for each run
+                              // (or part of a run) in [first, last)
+                              template <typename F>
+      void                    for_each(std::size_t first, std::size_t last, F&& f) const;
+
+   private:
+
+      struct run
+      {
+         std::size_t          start;
+         style_index          style;
+      };
+
+      using runs_vector = std::vector<run>;
+
+      runs_vector::const_iterator find(std::size_t pos) const;
+      void                    erase(std::size_t pos, std::size_t len);
+      void                    insert(std::size_t pos, std::size_t len);
+      void                    normalize();
+
+      runs_vector             _runs = {{0, 0}};
+      std::size_t             _size = 0;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Styled Text Box
+   //
+   // An editable text box with style runs. Style 0 is the default style,
+   // drawn with the text box's color. When the text changes, the runs
+   // follow the edit, and on_restyle is called for each changed line only,
+   // after its style is reset to the default. on_restyle is given the
+   // index of the first character of the line and the line's text, and
+   // styles it by calling style. Only the style runs in the visible lines
+   // are drawn, a glyph run for each style run in each line.
+   //
+   // Bold is drawn by stroking the glyphs, so that the text layout
+   // (computed using the text box's font) remains valid.
+   ////////////////////////////////////////////////////////////////////////////
+   class styled_text_box : public basic_text_box
+   {
+   public:
+
+      using style_index = style_runs::style_index;
+      using styles_vector = std::vector<text_style>;
+      using restyle_function = std::function<
+         void(styled_text_box& box, std::size_t first, std::u32string_view line)
+      >;
+
+                              styled_text_box(
+                                 std::string_view text
+                               , font_descr font_ = get_theme().text_box_font
+                              );
+
+                              styled_text_box(styled_text_box&& rhs) = default;
+
+      void                    draw(context const& ctx) override;
+
+      using basic_text_box::set_text;
+
+      style_index             add_style(text_style style);
+      text_style const&       get_style(style_index index) const  { return _styles[index]; }
+      void                    set_style(style_index index, text_style style);
+
+      void                    style(std::size_t first, std::size_t last, style_index index);
+      style_runs const&       runs() const                        { return _runs; }
+      void                    restyle();
+
+      restyle_function        on_restyle;
+
+   protected:
+
+      void                    edit_text(std::u32string_view text, text_edit const& edit) override;
+      void                    draw_text(context const& ctx) override;
+
+   private:
+
+      using piece_function = std::function<void(std::size_t first, std::size_t last, point p)>;
+
+      void                    restyle(std::size_t first, std::size_t last);
+      void                    for_each_piece(
+                                 context const& ctx
+                               , std::size_t first
+                               , std::size_t last
+                               , piece_function f
+                              );
+
+      styles_vector           _styles;
+      style_runs              _runs;
+      bool                    _restyle_all = true;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Inlines
+   ////////////////////////////////////////////////////////////////////////////
+   inline style_runs::style_index style_runs::style_at(std::size_t pos) const
+   {
+      return find(pos)->style;
+   }
+
+   template <typename F>
+   inline void style_runs::for_each(std::size_t first, std::size_t last, F&& f) const
+   {
+      last = std::min(last, _size);
+      for (auto i = find(first); i != _runs.end() && i->start < last; ++i)
+      {
+         auto next = (i + 1 != _runs.end())? (i + 1)->start : _size;
+         auto from = std::max(i->start, first);
+         auto to = std::min(next, last);
+         if (from < to)
+            f(from, to, i->style);
+      }
+   }
+}
+
+#endif
@@ -12,6 +12,9 @@
 #include <artist/text_layout.hpp>
 
 #include <infra/string_view.hpp>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 #include <set>
@@ -96,9 +99,17 @@ namespace cycfi::elements
       point                   current_size() const       { return _current_size; };
       void                    set_color(color c)         { _color = c; }
       color                   get_color() const          { return _color; }
-      void                    set_font(font_descr f)     { _font = f; }
+      virtual void            set_font(font_descr f)     { _font = f; }
       font const&             get_font() const           { return _font; }
 
+   protected:
+
+      // Set the text, given the edit that makes it from the current text.
+      // set_text, insert, replace and erase all go through here, so that
+      // derived classes can update what depends on the text incrementally
+      // without comparing the old and new text again.
+      virtual void            edit_text(std::u32string_view text, text_edit const& edit);
+
    private:
 
       void                    sync() const;
@@ -137,6 +148,7 @@ namespace cycfi::elements
 
       bool                    text(context const& ctx, text_info info) override;
       void                    set_text(std::u32string_view text) override;
+      void                    set_font(font_descr f) override;
 
       using element::focus;
       using static_text_box::get_text;
@@ -154,9 +166,31 @@ namespace cycfi::elements
 
       virtual void            draw_selection(context const& ctx);
       virtual void            draw_caret(context const& ctx);
+      virtual void            draw_matches(context const& ctx);
       virtual bool            word_break(int index) const;
       virtual bool            line_break(int index) const;
 
+      // Find and replace. find_next and find_previous select the next or
+      // previous match, relative to the selection, wrapping around the
+      // text. find_all finds all the matches in the background, a time
+      // slice per frame, calling on_find_all as matches are found. The
+      // matches are hilited, and are found again when the text changes,
+      // until clear_matches is called. The caller refreshes the view.
+      using find_all_function = std::function<void(std::size_t num_matches, bool done)>;
+      using matches_vector = std::vector<std::size_t>;
+
+      bool                    find_next(std::u32string_view pattern);
+      bool                    find_previous(std::u32string_view pattern);
+      void                    find_all(view& view_, std::u32string_view pattern);
+      void                    clear_matches();
+      matches_vector const&   matches() const               { return _matches; }
+      std::u32string_view     find_pattern() const          { return _find_pattern; }
+
+      bool                    replace_next(view& view_, std::u32string_view pattern, std::u32string_view with);
+      std::size_t             replace_all(view& view_, std::u32string_view pattern, std::u32string_view with);
+
+      find_all_function       on_find_all;
+
       basic_text_box&&        read_only() { _read_only = true; return std::move(*this); }
       void                    read_only(bool read_only_)    { _read_only = read_only_; }
       bool                    editable() const              { return !_read_only && _enabled; }
@@ -168,13 +202,23 @@ namespace cycfi::elements
 
    protected:
 
+      void                    edit_text(std::u32string_view text, text_edit const& edit) override;
       void                    scroll_into_view(context const& ctx, bool save_x);
       virtual void            delete_(bool forward);
       virtual void            cut(view& v, int start, int end);
       virtual void            copy(view& v, int start, int end);
       virtual void            paste(view& v, int start, int end);
 
-   private:
+      // Requests the clipboard text without blocking. The text is streamed
+      // into a buffer as it arrives, then f is called with all of it, on
+      // the UI thread, and the edit is added to the undo stack. A new
+      // request cancels a pending one, and so does destroying or moving
+      // the text box.
+      using paste_function = std::function<void(std::u32string_view text)>;
+      void                    request_paste(view& v, paste_function f);
+
+      virtual void            draw_text(context const& ctx);
+      void                    visible_range(context const& ctx, std::size_t& first, std::size_t& last);
 
       struct caret_metrics
       {
@@ -187,6 +231,8 @@ namespace cycfi::elements
       char32_t const*         caret_position(context const& ctx, point p);
       caret_metrics           caret_info(context const& ctx, char32_t const* s);
 
+   private:
+
       struct state_saver;
       using state_saver_f = std::function<void()>;
       using state_saver_ptr = std::shared_ptr<state_saver>;
@@ -194,6 +240,89 @@ namespace cycfi::elements
 
       state_saver_f           capture_state();
 
+      // The state of find_all while searching, shared with the view's frame
+      // clock. Like the state savers, it does not follow the text box
+      // when moved.
+      struct find_state
+      {
+         basic_text_box*      owner = nullptr;
+         view*                view_ = nullptr;
+         std::size_t          pos = 0;          // Where to continue searching
+         bool                 running = false;
+      };
+
+      using find_state_ptr = std::shared_ptr<find_state>;
+
+      struct find_holder
+      {
+                              find_holder() = default;
+                              find_holder(find_holder&&) {}
+                              ~find_holder() { if (ptr) ptr->owner = nullptr; }
+         find_holder&         operator=(find_holder&&) { return *this; }
+
+         find_state_ptr       ptr;
+      };
+
+      void                    start_find_all();
+      void                    update_matches(text_edit const& edit);
+      bool                    find_step(find_state& f);
+
+      // A pending request_paste, shared with the clipboard request
+      struct paste_state
+      {
+         basic_text_box*      owner = nullptr;
+         view*                view_ = nullptr;
+         paste_function       f;
+      };
+
+      using paste_state_ptr = std::shared_ptr<paste_state>;
+
+      struct paste_holder
+      {
+                              paste_holder() = default;
+                              paste_holder(paste_holder&&) {}
+                              ~paste_holder() { if (ptr) ptr->owner = nullptr; }
+         paste_holder&        operator=(paste_holder&&) { return *this; }
+
+         paste_state_ptr      ptr;
+      };
+
+      // The caret map: the caret x offsets, rows, and word and line break
+      // bitmaps of each hard line (up to and including its '\n'). A line
+      // is built from the text layout when first needed. An edit rebuilds
+      // only the lines it touches, and reflowing to a new width rebuilds
+      // all lines. caret_position bisects the map, and word and line
+      // navigation scan the bitmaps.
+      using break_bits = std::vector<std::uint64_t>;
+
+      struct caret_row
+      {
+         std::size_t          first;         // Relative to the line
+         float                y;             // Relative to the line
+      };
+
+      struct caret_line
+      {
+         std::size_t          first = 0;
+         std::size_t          size = 0;      // Including the '\n'
+         float                y = 0;
+         bool                 y_valid = false;
+         bool                 built = false;
+         std::vector<float>   x;             // For each caret position
+         std::vector<caret_row> rows;
+         break_bits           word_breaks;
+         break_bits           line_breaks;
+      };
+
+      using caret_lines = std::vector<caret_line>;
+
+      void                    sync_caret_map();
+      void                    update_caret_map(std::size_t pos, std::size_t old_len, std::size_t new_len);
+      caret_line&             get_caret_line(std::size_t line);
+      std::size_t             caret_line_of(std::size_t index);
+      float                   caret_line_y(std::size_t line);
+      std::size_t             find_break(std::size_t pos, bool line, bool value, bool forward);
+
       int                     _select_start;
       int                     _select_end;
       float                   _current_x;
@@ -205,6 +334,12 @@ namespace cycfi::elements
       bool                    _enabled : 1;
       bool                    _scroll_into_view : 1;
       state_saver_set         _state_savers;
+      std::u32string          _find_pattern;
+      matches_vector          _matches;
+      find_holder             _find;
+      paste_holder            _paste;
+      caret_lines             _caret_lines;
+      float                   _caret_map_width = -1;
    };
 
    ////////////////////////////////////////////////////////////////////////////
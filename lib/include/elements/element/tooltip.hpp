@@ -7,14 +7,83 @@
 #define ELEMENTS_TOOLTIP_AUGUST_27_2020
 
 #include <elements/element/proxy.hpp>
-#include <elements/element/popup.hpp>
+#include <elements/element/floating.hpp>
+#include <elements/view.hpp>
 #include <infra/support.hpp>
 #include <functional>
+#include <type_traits>
 
 namespace cycfi { namespace elements
 {
+   ////////////////////////////////////////////////////////////////////////////
+   // Tooltip Overlay
+   //
+   // A single floating layer per view (see view::tooltip_overlay()), shared
+   // by all the tooltips in the view. The overlay is added to the view the
+   // first time a tip is shown, and stays there, invisible and transparent
+   // to mouse events, while no tip is showing. Showing or hiding a tip lays
+   // out and refreshes only the tip's bounds.
+   //
+   // Only one tip can be pending or visible at a time. The tip is composed
+   // from its tip_function only when it is actually shown. If a tip is
+   // already visible when another tooltip is hovered, the new tip is shown
+   // immediately, without waiting for the delay.
+   ////////////////////////////////////////////////////////////////////////////
+   class tooltip_overlay_element : public floating_element
+   {
+   public:
+
+      using tip_function = std::function<element_ptr()>;
+      using hover_function = std::function<void(bool visible)>;
+
+                              tooltip_overlay_element(view& view_)
+                               : floating_element({})
+                               , _view(view_)
+                              {}
+
+      view_limits             limits(basic_context const& ctx) const override;
+      element const&          subject() const override;
+      element&                subject() override;
+
+      void                    draw(context const& ctx) override;
+      element*                hit_test(context const& ctx, point p, bool leaf, bool control) override;
+      bool                    cursor(context const& ctx, point p, cursor_tracking status) override;
+      bool                    wants_control() const override   { return is_visible(); }
+
+      void                    open(
+                                 void const* owner, rect anchor, duration delay
+                               , tip_function tip, hover_function on_hover
+                              );
+      void                    close(void const* owner);
+
+      bool                    is_open(void const* owner) const { return _owner && _owner == owner; }
+      bool                    is_visible() const               { return _tip != nullptr; }
+      bool                    cursor_in_tip() const            { return _cursor_in_tip; }
+
+   private:
+
+      using timer_ptr = std::weak_ptr<asio::steady_timer>;
+
+      void                    show();
+      void                    refresh_tip();
+      rect                    device_to_overlay(rect r) const;
+
+      view&                   _view;
+      void const*             _owner = nullptr;
+      rect                    _anchor;
+      tip_function            _make_tip;
+      hover_function          _on_hover;
+      element_ptr             _tip;
+      timer_ptr               _timer;
+      bool                    _cursor_in_tip = false;
+   };
+
    ////////////////////////////////////////////////////////////////////////////
    // Tooltip elements
+   //
+   // The tip may be given as an element, or as a function returning the
+   // element (or an element_ptr). In the latter case, the tip is composed
+   // lazily, only when it is about to be shown.
    ////////////////////////////////////////////////////////////////////////////
    class tooltip_element : public proxy_base
    {
@@ -22,13 +91,16 @@ namespace cycfi { namespace elements
 
       using base_type = proxy_base;
       using on_hover_function = std::function<void(bool visible)>;
+      using tip_function = tooltip_overlay_element::tip_function;
 
                               template <typename Tip>
                               tooltip_element(Tip&& tip, duration delay)
-                               : _tip(share(basic_popup(std::forward<Tip>(tip))))
+                               : _tip(make_tip_function(std::forward<Tip>(tip)))
                                , _delay(delay)
                               {}
 
+                              ~tooltip_element();
+
       bool                    cursor(context const& ctx, point p, cursor_tracking status) override;
       bool                    key(context const& ctx, key_info k) override;
 
@@ -36,16 +108,14 @@ namespace cycfi { namespace elements
 
    private:
 
-      using popup_ptr = std::shared_ptr<basic_popup_element>;
-      enum status {tip_hidden, tip_delayed, tip_visible};
+                              template <typename Tip>
+      static tip_function     make_tip_function(Tip&& tip);
 
-      rect                    tip_bounds(context const& ctx) const;
-      void                    close_tip(view& view_);
+      using overlay_ptr = std::weak_ptr<tooltip_overlay_element>;
 
-      popup_ptr               _tip;
-      status                  _tip_status = tip_hidden;
+      tip_function            _tip;
       duration                _delay;
-      bool                    _cursor_in_tip = false;
+      overlay_ptr             _overlay;   // The overlay showing our tip, if any
    };
 
    template <typename Subject, typename Tip>
@@ -54,6 +124,26 @@ namespace cycfi { namespace elements
    {
       return {std::forward<Subject>(subject), std::forward<Tip>(tip), delay};
    }
+
+   template <typename Tip>
+   inline tooltip_element::tip_function
+   tooltip_element::make_tip_function(Tip&& tip)
+   {
+      if constexpr (std::is_invocable_v<remove_cvref_t<Tip>>)
+      {
+         return [f = std::forward<Tip>(tip)]() -> element_ptr
+         {
+            return detail::add_element(f());
+         };
+      }
+      else
+      {
+         return [e = detail::add_element(std::forward<Tip>(tip))]() -> element_ptr
+         {
+            return e;
+         };
+      }
+   }
 }}
 
 #endif
@@ -10,26 +10,345 @@
 #include <vector>
 #include <string>
 #include <string_view>
-#include <variant>
+#include <memory>
+#include <functional>
+#include <iterator>
 #include <cstddef>
+#include <cstdint>
+#include <stdexcept>
 #include <infra/filesystem.hpp>
 
 namespace cycfi::elements
 {
+   ////////////////////////////////////////////////////////////////////////////
+   // payload_buffer is a ref-counted, immutable buffer of bytes. Copying a
+   // payload_buffer does not copy the data, it simply shares it. The buffer
+   // can take ownership of a std::string or std::vector<std::byte> (by move,
+   // without copying), or adopt memory owned by something else (e.g. a host
+   // clipboard or drag and drop object), kept alive by the given owner.
+   ////////////////////////////////////////////////////////////////////////////
+   class payload_buffer
+   {
+   public:
+
+      using owner_ptr = std::shared_ptr<void const>;
+
+                              payload_buffer() = default;
+                              payload_buffer(std::string text);
+                              payload_buffer(char const* text);
+                              payload_buffer(std::vector<std::byte> bytes);
+                              payload_buffer(owner_ptr owner, void const* data, std::size_t size);
+
+      char const*             data() const   { return _data; }
+      std::size_t             size() const   { return _size; }
+      bool                    empty() const  { return _size == 0; }
+
+      std::string_view        text() const   { return {_data, _size}; }
+      std::byte const*        bytes() const  { return reinterpret_cast<std::byte const*>(_data); }
+
+   private:
+
+      owner_ptr               _owner;
+      char const*             _data = nullptr;
+      std::size_t             _size = 0;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // payload_data is the data associated with a MIME type in a payload. The
+   // data is either available right away, or provided lazily by a function
+   // that is called only when the data is actually needed (e.g. when a drop
+   // is accepted). Copies of a payload_data share the same state, so the
+   // data is provided at most once.
+   ////////////////////////////////////////////////////////////////////////////
+   class payload_data
+   {
+   public:
+
+      using provider_function = std::function<payload_buffer()>;
+
+                              payload_data() = default;
+                              payload_data(payload_buffer buffer);
+                              payload_data(std::string text);
+                              payload_data(char const* text);
+                              payload_data(std::vector<std::byte> bytes);
+      explicit                payload_data(provider_function provide);
+
+      bool                    is_ready() const;
+      payload_buffer const&   buffer() const;
+      std::string_view        text() const   { return buffer().text(); }
+
+   private:
+
+      struct state
+      {
+         provider_function    provide;
+         payload_buffer       buffer;
+      };
+
+      using state_ptr = std::shared_ptr<state>;
+
+      state_ptr               _state;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // MIME types are interned to small integer IDs. Interning the same MIME
+   // type always gives the same ID. A mime_set is a set of interned MIME
+   // types, represented as a bitset, so that testing if two sets have any
+   // MIME type in common is a handful of bitwise ANDs.
+   //
+   // Only the MIME types accepted by drop targets are interned, when the
+   // targets register them. find_mime_type looks up a MIME type without
+   // interning it, and returns no_mime_id if it has not been interned: no
+   // drop target accepts it. num_mime_types() is the number of interned
+   // MIME types. It changes only when a new MIME type is interned.
+   ////////////////////////////////////////////////////////////////////////////
+   using mime_id = std::size_t;
+   constexpr mime_id no_mime_id = mime_id(-1);
+
+   mime_id                 intern_mime_type(std::string_view mime_type);
+   mime_id                 find_mime_type(std::string_view mime_type);
+   std::size_t             num_mime_types();
+
+   class mime_set
+   {
+   public:
+
+      void                    insert(mime_id id);
+      bool                    contains(mime_id id) const;
+      bool                    intersects(mime_set const& other) const;
+      bool                    empty() const;
+      void                    clear()        { _bits.clear(); }
+
+   private:
+
+      using block = std::uint64_t;
+      static constexpr std::size_t block_bits = 64;
+
+      std::vector<block>      _bits;
+   };
+
    ////////////////////////////////////////////////////////////////////////////
    // payload is a container of data for transferring information around.
-   // payload *is-a* std::map with std::string keys that defines the format
-   // of the data, using MIME types (e.g. "text/plain"). The actual data is a
-   // std::variant<std::string, std::vector<std::byte>>. std::string for text
-   // and std::vector<std::byte> for everything else.
+   // payload maps std::string keys that define the format of the data, using
+   // MIME types (e.g. "text/plain"), to the actual data, a payload_data (see
+   // above). The interface is that of a std::map, with heterogeneous lookup,
+   // (e.g. find with a std::string_view does not allocate).
+   //
+   // mime_types() returns the interned MIME types of the payload's keys. It
+   // is computed once, when first needed, and recomputed only when keys have
+   // been added or removed, or new MIME types have been interned.
    ////////////////////////////////////////////////////////////////////////////
-   using payload_data = std::variant<std::string, std::vector<std::byte>>;
+   class payload
+   {
+   public:
 
-   struct payload : std::map<std::string, payload_data>
+      using map_type = std::map<std::string, payload_data, std::less<>>;
+      using key_type = map_type::key_type;
+      using mapped_type = map_type::mapped_type;
+      using value_type = map_type::value_type;
+      using size_type = map_type::size_type;
+      using iterator = map_type::iterator;
+      using const_iterator = map_type::const_iterator;
+
+                              payload() = default;
+                              payload(std::initializer_list<value_type> list);
+
+      payload&                operator=(std::initializer_list<value_type> list);
+
+      iterator                begin()              { return _map.begin(); }
+      iterator                end()                { return _map.end(); }
+      const_iterator          begin() const        { return _map.begin(); }
+      const_iterator          end() const          { return _map.end(); }
+      bool                    empty() const        { return _map.empty(); }
+      size_type               size() const         { return _map.size(); }
+
+                              template <typename K>
+      iterator                find(K const& key)         { return _map.find(key); }
+                              template <typename K>
+      const_iterator          find(K const& key) const   { return _map.find(key); }
+                              template <typename K>
+      size_type               count(K const& key) const  { return _map.count(key); }
+
+      payload_data&           at(std::string_view key);
+      payload_data const&     at(std::string_view key) const;
+      payload_data&           operator[](std::string const& key);
+      payload_data&           operator[](std::string&& key);
+
+                              template <typename... T>
+      auto                    insert(T&&... args);
+                              template <typename... T>
+      auto                    emplace(T&&... args);
+                              template <typename... T>
+      auto                    try_emplace(T&&... args);
+                              template <typename... T>
+      auto                    insert_or_assign(T&&... args);
+
+      iterator                erase(const_iterator pos);
+      size_type               erase(std::string_view key);
+      void                    clear();
+      void                    swap(payload& other);
+
+      mime_set const&         mime_types() const;
+
+   private:
+
+      map_type                _map;
+      mutable mime_set        _mime_types;
+      mutable std::size_t     _num_mime_types = 0;    // num_mime_types() for _mime_types
+      mutable bool            _mime_types_valid = false;
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Inlines
+   ////////////////////////////////////////////////////////////////////////////
+   inline payload::payload(std::initializer_list<value_type> list)
+    : _map(list)
+   {}
+
+   inline payload& payload::operator=(std::initializer_list<value_type> list)
+   {
+      _map = list;
+      _mime_types_valid = false;
+      return *this;
+   }
+
+   inline payload_data& payload::at(std::string_view key)
+   {
+      auto i = _map.find(key);
+      if (i == _map.end())
+         throw std::out_of_range("payload::at");
+      return i->second;
+   }
+
+   inline payload_data const& payload::at(std::string_view key) const
+   {
+      auto i = _map.find(key);
+      if (i == _map.end())
+         throw std::out_of_range("payload::at");
+      return i->second;
+   }
+
+   inline payload_data& payload::operator[](std::string const& key)
+   {
+      auto [i, inserted] = _map.try_emplace(key);
+      if (inserted)
+         _mime_types_valid = false;
+      return i->second;
+   }
+
+   inline payload_data& payload::operator[](std::string&& key)
    {
-      using base_type = std::map<std::string, payload_data>;
-      using base_type::base_type;
-      using base_type::operator=;
+      auto [i, inserted] = _map.try_emplace(std::move(key));
+      if (inserted)
+         _mime_types_valid = false;
+      return i->second;
+   }
+
+   template <typename... T>
+   inline auto payload::insert(T&&... args)
+   {
+      _mime_types_valid = false;
+      return _map.insert(std::forward<T>(args)...);
+   }
+
+   template <typename... T>
+   inline auto payload::emplace(T&&... args)
+   {
+      _mime_types_valid = false;
+      return _map.emplace(std::forward<T>(args)...);
+   }
+
+   template <typename... T>
+   inline auto payload::try_emplace(T&&... args)
+   {
+      _mime_types_valid = false;
+      return _map.try_emplace(std::forward<T>(args)...);
+   }
+
+   template <typename... T>
+   inline auto payload::insert_or_assign(T&&... args)
+   {
+      _mime_types_valid = false;
+      return _map.insert_or_assign(std::forward<T>(args)...);
+   }
+
+   inline payload::iterator payload::erase(const_iterator pos)
+   {
+      _mime_types_valid = false;
+      return _map.erase(pos);
+   }
+
+   inline payload::size_type payload::erase(std::string_view key)
+   {
+      auto i = _map.find(key);
+      if (i == _map.end())
+         return 0;
+      erase(i);
+      return 1;
+   }
+
+   inline void payload::clear()
+   {
+      _mime_types_valid = false;
+      _map.clear();
+   }
+
+   inline void payload::swap(payload& other)
+   {
+      _map.swap(other._map);
+      std::swap(_mime_types, other._mime_types);
+      std::swap(_num_mime_types, other._num_mime_types);
+      std::swap(_mime_types_valid, other._mime_types_valid);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // file_paths iterates over the file paths in a "text/uri-list", in place.
+   // The paths are string_views into the payload's (shared) buffer, with the
+   // "file://" prefix removed. Lines that are not file URIs are skipped.
+   ////////////////////////////////////////////////////////////////////////////
+   class file_paths
+   {
+   public:
+
+      class iterator
+      {
+      public:
+
+         using iterator_category = std::forward_iterator_tag;
+         using value_type = std::string_view;
+         using difference_type = std::ptrdiff_t;
+         using pointer = std::string_view const*;
+         using reference = std::string_view const&;
+
+                              iterator() = default;
+                              iterator(std::string_view text);
+
+         reference            operator*() const    { return _path; }
+         pointer              operator->() const   { return &_path; }
+         iterator&            operator++();
+         iterator             operator++(int);
+
+         bool                 operator==(iterator const& rhs) const;
+         bool                 operator!=(iterator const& rhs) const  { return !(*this == rhs); }
+
+      private:
+
+         void                 next();
+
+         std::string_view     _rest;
+         std::string_view     _path;
+         bool                 _done = true;
+      };
+
+                              file_paths(payload const& data);
+
+      iterator                begin() const  { return iterator{_buffer.text()}; }
+      iterator                end() const    { return {}; }
+      bool                    empty() const  { return begin() == end(); }
+
+   private:
+
+      payload_buffer          _buffer;
    };
 
    bool                    contains_filepaths(payload const& data);
@@ -37,4 +356,3 @@ namespace cycfi::elements
 }
 
 #endif
-
@@ -8,7 +8,13 @@
 
 #include <artist/canvas.hpp>
 #include <artist/font.hpp>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
 #include <string_view>
+#include <type_traits>
 
 namespace cycfi::elements
 {
@@ -28,6 +34,96 @@ namespace cycfi::elements
    inline point   measure_text(canvas& cnv, std::string_view text, font_descr font_, float size)
                   { return measure_text(cnv, text, font_.size(size)); }
 
+   ////////////////////////////////////////////////////////////////////////////
+   // Text Edit
+   //
+   // The range changed by an edit from one text to another: new_len
+   // characters at pos replace old_len characters. The range is what is
+   // left between the common prefix and the common suffix of both texts.
+   ////////////////////////////////////////////////////////////////////////////
+   struct text_edit
+   {
+      std::size_t    pos = 0;
+      std::size_t    old_len = 0;
+      std::size_t    new_len = 0;
+
+      bool           empty() const { return old_len == 0 && new_len == 0; }
+   };
+
+   text_edit      find_edit(std::u32string_view from, std::u32string_view to);
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Label Text
+   //
+   // Text storage for labels. Short strings are stored in place, without
+   // allocating. Longer strings are immutable, and are shared by copies
+   // (and by labels constructed from the same shared string). Numbers are
+   // formatted directly into the in-place buffer.
+   ////////////////////////////////////////////////////////////////////////////
+   class label_text
+   {
+   public:
+
+      using shared_string = std::shared_ptr<std::string const>;
+      static constexpr std::size_t small_size = 31;
+
+                     label_text() = default;
+                     label_text(std::string_view text)   { assign(text); }
+                     label_text(std::string const& text) { assign(text); }
+                     label_text(char const* text)        { assign(text); }
+                     label_text(shared_string text)      { assign(std::move(text)); }
+
+      void           assign(std::string_view text);
+      void           assign(shared_string text);
+
+                     template <typename T>
+      std::enable_if_t<std::is_arithmetic_v<T>>
+                     assign_number(T val);
+
+      std::string_view view() const;
+                     operator std::string_view() const   { return view(); }
+
+   private:
+
+      shared_string  _shared;
+      std::uint8_t   _size = 0;
+      char           _small[small_size] = {};
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Inlines
+   ////////////////////////////////////////////////////////////////////////////
+   inline std::string_view label_text::view() const
+   {
+      if (_shared)
+         return *_shared;
+      return {_small, _size};
+   }
+
+   template <typename T>
+   inline std::enable_if_t<std::is_arithmetic_v<T>>
+   label_text::assign_number(T val)
+   {
+      if constexpr (std::is_integral_v<T>)
+      {
+         // Integers always fit in the in-place buffer
+         auto r = std::to_chars(_small, _small + small_size, val);
+         _size = std::uint8_t(r.ptr - _small);
+         _shared.reset();
+      }
+      else
+      {
+         char buff[64];
+#if defined(__cpp_lib_to_chars)
+         auto r = std::to_chars(buff, buff + sizeof(buff), val);
+         auto size = std::size_t(r.ptr - buff);
+#else
+         auto size = std::size_t(std::snprintf(buff, sizeof(buff), "%g", double(val)));
+#endif
+         assign(std::string_view{buff, size});
+      }
+   }
+
 ////////////////////////////////////////////////////////////////////////////
    // Helper for converting char8_t[] string literals to char[]
    ////////////////////////////////////////////////////////////////////////////
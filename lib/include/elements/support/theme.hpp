@@ -7,6 +7,9 @@
 #define ELEMENTS_THEME_APRIL_15_2016
 
 #include <elements/support.hpp>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
 namespace cycfi { namespace elements
 {
@@ -66,6 +69,7 @@ namespace cycfi { namespace elements
       color                text_box_font_color;
       font_descr           text_box_font;
       color                text_box_hilite_color;
+      color                text_box_match_color;
       color                text_box_caret_color;
       float                text_box_caret_width;
       color                inactive_font_color;
@@ -92,68 +96,132 @@ namespace cycfi { namespace elements
       float                child_window_opacity;
    };
 
-   // Access to the global theme
+   ////////////////////////////////////////////////////////////////////////////
+   // Theme snapshots
+   //
+   // Themes are immutable, ref-counted snapshots (theme_ptr). A snapshot is
+   // never modified once made. set_theme replaces the global snapshot with
+   // a new one, and overrides make new snapshots derived from the current
+   // one. Holding on to a theme_ptr keeps the snapshot alive, and comparing
+   // theme_ptrs tells if anything changed. Caches can be keyed on the
+   // snapshot's identity.
+   //
+   // get_theme() always returns a snapshot, never an object that changes
+   // under the caller. Inside a scoped_theme, that is the scope's snapshot.
+   // Outside, it is the global snapshot pinned by the calling thread: a
+   // new snapshot set by set_theme (from any thread) is picked up, and the
+   // snapshots pinned before remain alive until the thread enters its next
+   // outermost scoped_theme (e.g. the view's next draw or event). Hold a
+   // theme_ptr to keep a snapshot for longer.
+   //
+   // Each thread has its own current theme, installed for the duration of
+   // a scope using scoped_theme. It defaults to the global theme. get_theme()
+   // returns the current theme of the calling thread. Nothing is shared and
+   // mutated while drawing, so different threads can render using different
+   // themes at the same time. The view installs its local theme, if it has
+   // one, while drawing and dispatching events (see view::local_theme).
+   ////////////////////////////////////////////////////////////////////////////
+   using theme_ptr = std::shared_ptr<theme const>;
+
+   // Access to the current theme
    theme const& get_theme();
+   theme_ptr get_theme_ptr();
 
    // Set the global theme
    void set_theme(theme const& thm);
+   void set_theme(theme_ptr thm);
 
-   template <typename T>
-   class scoped_theme_override
+   // Make the theme, `thm`, the current theme in the current scope, for
+   // the current thread. If `thm` is null, the current theme is unchanged.
+   class scoped_theme
    {
    public:
+                              scoped_theme(theme_ptr thm);
+                              scoped_theme(scoped_theme&& rhs);
+                              ~scoped_theme();
 
-       scoped_theme_override(theme& thm, T theme::*pmem, T val)
-       : _thm(thm)
-       , _pmem(pmem)
-       , _save(thm.*pmem)
-      {
-         _thm.*_pmem = val;
-      }
-
-       scoped_theme_override(scoped_theme_override&& rhs)
-       : _thm(rhs._thm)
-       , _pmem(rhs._pmem)
-       , _save(rhs._thm.*_pmem)
-      {
-         rhs._pmem = nullptr;
-      }
-
-      ~scoped_theme_override()
-      {
-         if (_pmem)
-            _thm.*_pmem = _save;
-      }
+                              scoped_theme(scoped_theme const&) = delete;
+      scoped_theme&           operator=(scoped_theme const&) = delete;
 
    private:
 
-      theme&      _thm;
-      T theme::*  _pmem;
-      T           _save;
+      theme_ptr               _theme;
+      theme_ptr const*        _save = nullptr;
+      bool                    _active = false;
    };
 
-   class global_theme
+   namespace detail
    {
+      template <typename T, typename = void>
+      struct is_equality_comparable : std::false_type {};
+
       template <typename T>
-      friend class scoped_theme_override;
+      struct is_equality_comparable<
+         T, std::void_t<decltype(std::declval<T const&>() == std::declval<T const&>())>
+      > : std::true_type {};
+   }
 
-      friend theme const& get_theme();
-      friend void set_theme(theme const& thm);
+   // Make a new snapshot derived from `base`, with the member `pmem` set to
+   // `val`. The most recently derived snapshots are remembered (per thread),
+   // so overriding the same member with the same value again gives back the
+   // same snapshot. This keeps the snapshot identity stable across frames
+   // (e.g. overrides done on every draw).
+   template <typename T>
+   inline theme_ptr derive_theme(theme_ptr const& base, T theme::*pmem, T const& val)
+   {
+      auto make = [&]
+      {
+         auto thm = std::make_shared<theme>(*base);
+         (*thm).*pmem = val;
+         return theme_ptr{std::move(thm)};
+      };
 
-      template <typename T>
-      friend scoped_theme_override<T>
-      override_theme(T theme::*pmem, T val);
+      if constexpr (detail::is_equality_comparable<T>::value)
+      {
+         struct entry
+         {
+            theme_ptr      base;
+            T theme::*     pmem = nullptr;
+            theme_ptr      derived;
+         };
+
+         static constexpr std::size_t memo_size = 8;
+         thread_local entry memo[memo_size];
+         thread_local std::size_t next = 0;
+
+         for (auto const& e : memo)
+         {
+            if (e.derived && e.base == base && e.pmem == pmem && (*e.derived).*pmem == val)
+               return e.derived;
+         }
+         auto derived = make();
+         memo[next++ % memo_size] = {base, pmem, derived};
+         return derived;
+      }
+      else
+      {
+         return make();
+      }
+   }
 
-      static theme& _theme();
+   // Override a member of the current theme in the current scope
+   template <typename T>
+   class scoped_theme_override : public scoped_theme
+   {
+   public:
+
+                              scoped_theme_override(T theme::*pmem, T val)
+                               : scoped_theme(derive_theme(get_theme_ptr(), pmem, val))
+                              {}
+
+                              scoped_theme_override(scoped_theme_override&& rhs) = default;
    };
 
    template <typename T>
-   scoped_theme_override<T>
+   inline scoped_theme_override<T>
    override_theme(T theme::*pmem, T val)
    {
-      return scoped_theme_override<T>{
-         global_theme::_theme(), pmem, val
-      };
+      return scoped_theme_override<T>{pmem, val};
    }
 }}
 
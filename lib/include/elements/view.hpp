@@ -13,10 +13,12 @@
 #include <elements/element/size.hpp>
 #include <elements/element/indirect.hpp>
 #include <elements/support/context.hpp>
+#include <elements/support/theme.hpp>
 
 #include <asio.hpp>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <chrono>
 #include <stack>
 #include <map>
@@ -26,6 +28,7 @@ namespace cycfi { namespace elements
    class context;
    class window;
    class idle_tasks;
+   class tooltip_overlay_element;
 
    class view : public base_view
    {
@@ -53,11 +56,21 @@ namespace cycfi { namespace elements
       float                   scale() const;
       void                    scale(float val);
 
+      // Continuous zooming. While zooming, a snapshot of the content is
+      // drawn scaled instead of laying out and drawing the content at each
+      // step (see scale_element). zoom begins zooming if needed and ends it
+      // once there are no more zoom steps for a while.
+      void                    begin_zoom();
+      void                    end_zoom();
+      void                    zoom(float val);
+      bool                    is_zooming() const      { return _main_element.is_zooming(); }
+
       void                    refresh() override;
       void                    refresh(rect area) override;
       void                    refresh(context const& ctx, rect area);
       void                    refresh(element& element, int outward = 0);
       void                    refresh(context const& ctx, int outward = 0);
+      void                    refresh_layers(rect area);
       rect                    dirty() const;
 
       struct undo_redo_task
@@ -79,6 +92,8 @@ namespace cycfi { namespace elements
       scaled_content&         main_element()         { return _main_element; }
       scaled_content const&   main_element() const   { return _main_element; }
 
+      // Direct access to the layers. Prefer add and remove, which lay out
+      // and refresh only the affected layer.
       content_type&           content();
       content_type const&     content() const;
       void                    content(std::initializer_list<element_ptr> list);
@@ -98,6 +113,10 @@ namespace cycfi { namespace elements
       view_limits             limits() const;
       mouse_button            current_button() const;
 
+      // Incremented on each limits and layout pass over the content.
+      // Elements may cache what they compute for the current pass.
+      std::size_t             layout_pass() const    { return _layout_pass; }
+
       using change_limits_function = std::function<void(view_limits limits_)>;
       change_limits_function on_change_limits;
 
@@ -113,6 +132,14 @@ namespace cycfi { namespace elements
                               template <typename F>
       void                    post(F f);
 
+      // The frame clock. The function is called once per frame, with the
+      // time elapsed since the previous frame, for as long as it returns
+      // true. The clock runs only while there are functions to call.
+      using frame_duration = std::chrono::duration<double>;
+      using frame_function = std::function<bool(frame_duration dt)>;
+
+      void                    on_frame(frame_function f);
+
       using tracking = element::tracking;
 
       using track_function = std::function<void(element& e, tracking state)>;
@@ -120,20 +147,50 @@ namespace cycfi { namespace elements
 
       void                    manage_on_tracking(element& e, tracking state);
 
+      // The theme used by this view. If not set, the global theme is used.
+      theme_ptr               local_theme() const          { return _local_theme; }
+      void                    local_theme(theme_ptr thm);
+
+      // The tooltip overlay shared by all tooltips in this view (see tooltip.hpp)
+      tooltip_overlay_element& tooltip_overlay();
+
+      // Shortcuts. A key press is looked up in the shortcut registry before
+      // it is dispatched to the elements, which is done by walking down the
+      // focused elements (see composite_base::key). The shortcut's function
+      // returns true if it handled the key. Shortcuts are tried in the order
+      // they were added. Popup menus register the shortcuts of their items
+      // while they are open (see basic_popup_menu_element).
+      using shortcut_function = std::function<bool()>;
+      using shortcut_id = std::size_t;
+
+      shortcut_id             add_shortcut(shortcut_key key, shortcut_function f);
+      void                    remove_shortcut(shortcut_id id);
+
    private:
 
       scaled_content          make_scaled_content() { return elements::scale(1.0, link(_content)); }
 
+      using layers_set = std::unordered_set<element_ptr>;
+
       layer_composite         _content;
+      layers_set              _layers;
       scaled_content          _main_element;
 
+      layers_set&             open_layers();
       void                    set_limits();
+      void                    frame();
+      void                    layout_layer(std::size_t index);
+      void                    refresh_layer(std::size_t index);
+      int                     focus_layer() const;
+      void                    end_layer_focus();
+      void                    begin_layer_focus();
 
       rect                    _dirty;
       rect                    _current_bounds;
       view_limits             _current_limits = {{0, 0}, { full_extent, full_extent}};
       mouse_button            _current_button;
       bool                    _is_focus = false;
+      std::size_t             _layout_pass = 1;
 
       using undo_stack_type = std::stack<undo_redo_task>;
       undo_stack_type         _undo_stack;
@@ -146,6 +203,35 @@ namespace cycfi { namespace elements
       using tracking_map = std::map<element*, time_point>;
 
       tracking_map            _tracking;
+
+      using tooltip_overlay_ptr = std::shared_ptr<tooltip_overlay_element>;
+      tooltip_overlay_ptr     _tooltip_overlay;
+      theme_ptr               _local_theme;
+      steady_timer_ptr        _zoom_timer;
+
+      using frame_functions = std::vector<frame_function>;
+
+      frame_functions         _frame_functions;
+      steady_timer_ptr        _frame_timer;
+      time_point              _last_frame;
+
+      using shortcut_function_ptr = std::shared_ptr<shortcut_function>;
+
+      struct shortcut_info
+      {
+         shortcut_id             id;
+         shortcut_key            key;
+         shortcut_function_ptr   f;
+      };
+
+      using shortcuts_vector = std::vector<shortcut_info>;
+      using shortcuts_map = std::unordered_map<key_code, shortcuts_vector>;
+
+      bool                    shortcut(key_info const& k);
+
+      shortcuts_map           _shortcuts;
+      shortcut_id             _next_shortcut_id = 0;
+      std::size_t             _shortcuts_generation = 0;
    };
 
    ////////////////////////////////////////////////////////////////////////////
@@ -203,6 +289,7 @@ namespace cycfi { namespace elements
    {
       _content = list;
       std::reverse(_content.begin(), _content.end());
+      _layers = {_content.begin(), _content.end()};
       set_limits();
    }
 
@@ -226,107 +313,23 @@ namespace cycfi { namespace elements
    {
       _content = {detail::add_element(std::forward<E>(elements))...};
       std::reverse(_content.begin(), _content.end());
+      _layers = {_content.begin(), _content.end()};
       set_limits();
    }
 
-   inline void view::add(element_ptr e)
+   inline view::layers_set& view::open_layers()
    {
-      // We'll defer this call just to be safe, to give the trigger that
-      // initiated this call (e.g. button on_click) a chance to return.
-      if (e)
-      {
-         if (_content.empty()
-            || std::find(_content.begin(), _content.end(), e) != _content.end())
-            return;
-
-         io().post(
-            [e, this]
-            {
-               end_focus();
-               _content.push_back(e);
-               layout(*e);
-               _is_focus = true;
-               begin_focus();
-               _is_focus = _main_element.focus();
-            }
-         );
-      }
-   }
-
-   inline void view::remove(element_ptr e)
-   {
-      // We want to dismiss the element, but we can't do it immediately
-      // because we need to retain the trigger that initiated this call (e.g.
-      // button on_click), otherwise there's nothing to return to. So, we
-      // post a function that is called at idle time.
-      if (e)
-      {
-         io().post(
-            [e, this]
-            {
-               auto i = std::find(_content.begin(), _content.end(), e);
-               if (i != _content.end())
-               {
-                  end_focus();
-                  refresh(*e);
-                  _content.erase(i);
-                  _content.reset();
-                  layout();
-                  _is_focus = true;
-                  begin_focus();
-                  _is_focus = _main_element.focus();
-               }
-            }
-         );
-      }
+      // The layers may have been changed directly, through content() or
+      // main_element(). If so, rebuild the set.
+      if (_layers.size() != _content.size())
+         _layers = {_content.begin(), _content.end()};
+      return _layers;
    }
 
    inline bool view::is_open(element_ptr e)
    {
-      auto i = std::find(_content.begin(), _content.end(), e);
-      return i != _content.end();
-   }
-
-   inline void view::move_to_front(element_ptr e)
-   {
-      if (e && _content.back() != e)
-      {
-         io().post(
-            [e, this]
-            {
-               auto i = std::find(_content.begin(), _content.end(), e);
-               if (i != _content.end())
-               {
-                  end_focus();
-                  std::rotate(i, i+1, _content.end());
-                  _content.reset();
-                  layout();
-                  begin_focus();
-               }
-            }
-         );
-      }
-   }
-
-   inline void view::move_to_back(element_ptr e)
-   {
-      if (e && _content.front() != e)
-      {
-         io().post(
-            [e, this]
-            {
-               auto i = std::find(_content.begin(), _content.end(), e);
-               if (i != _content.end())
-               {
-                  end_focus();
-                  std::rotate(_content.begin(), i, i+1);
-                  _content.reset();
-                  layout();
-                  begin_focus();
-               }
-            }
-         );
-      }
+      auto const& layers = open_layers();
+      return layers.find(e) != layers.end();
    }
 
    inline view::layers_vector const& view::layers() const
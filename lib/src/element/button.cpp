@@ -49,16 +49,16 @@ namespace cycfi { namespace elements
 
    bool basic_button::cursor(context const& ctx, point /* p */, cursor_tracking status)
    {
-      hilite(status != cursor_tracking::leaving);
-      if (update_receiver())
+      // Refresh only when the hilite state actually changes
+      if (hilite(status != cursor_tracking::leaving))
          ctx.view.refresh(ctx);
       return false;
    }
 
    void basic_button::drag(context const& ctx, mouse_button btn)
    {
-      this->hilite(ctx.bounds.includes(btn.pos));
-      if (state(ctx.bounds.includes(btn.pos)))
+      bool hilite_changed = this->hilite(ctx.bounds.includes(btn.pos));
+      if (state(ctx.bounds.includes(btn.pos)) || hilite_changed)
          ctx.view.refresh(ctx);
    }
 
@@ -97,13 +97,14 @@ namespace cycfi { namespace elements
          update_receiver();
       }
    }
-   void basic_button::hilite(bool val)
+   bool basic_button::hilite(bool val)
    {
       if (val != _state.hilite)
       {
          _state.hilite = val;
-         update_receiver();
+         return update_receiver();
       }
+      return false;
    }
 
    bool basic_button::update_receiver()
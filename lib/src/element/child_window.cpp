@@ -6,12 +6,56 @@
 #include <elements/element/child_window.hpp>
 #include <elements/element/floating.hpp>
 #include <elements/view.hpp>
+#include <artist/canvas.hpp>
+#include <cmath>
 
 namespace cycfi { namespace elements
 {
    ////////////////////////////////////////////////////////////////////////////
    // child_window_element
    ////////////////////////////////////////////////////////////////////////////
+   void child_window_element::draw(context const& ctx)
+   {
+      if (_cached && _moving)
+         draw_layer(ctx);
+      else
+         floating_element::draw(ctx);
+   }
+
+   void child_window_element::draw_layer(context const& ctx)
+   {
+      auto b = bounds();
+      if (!_layer)
+      {
+         // Render the window once, in device pixels, covering its bounds
+         auto tl = ctx.canvas.user_to_device(b.top_left());
+         auto br = ctx.canvas.user_to_device(b.bottom_right());
+         auto device_scale = (br.x - tl.x) / b.width();
+
+         _layer = std::make_shared<artist::image>(
+            extent{std::ceil(b.width() * device_scale), std::ceil(b.height() * device_scale)}
+         );
+
+         artist::offscreen_image offscr{*_layer};
+         canvas cnv{offscr.context()};
+         cnv.pre_scale(device_scale);
+         cnv.translate(-b.left, -b.top);
+         floating_element::draw(context{ctx.view, cnv, this, ctx.bounds});
+      }
+      ctx.canvas.draw(*_layer, b);
+   }
+
+   void child_window_element::begin_move()
+   {
+      _moving = true;
+   }
+
+   void child_window_element::end_move()
+   {
+      _moving = false;
+      _layer.reset();
+   }
+
    bool child_window_element::click(context const& ctx, mouse_button btn)
    {
       if (btn.down)
@@ -88,6 +132,12 @@ namespace cycfi { namespace elements
       }
    }
 
+   void movable_base::begin_tracking(context const& ctx, tracker_info& /* track_info */)
+   {
+      if (auto cw = find_parent<child_window_element*>(ctx))
+         cw->begin_move();
+   }
+
    void movable_base::keep_tracking(context const& ctx, tracker_info& track_info)
    {
       if (track_info.current != track_info.previous)
@@ -95,13 +145,25 @@ namespace cycfi { namespace elements
          auto fl = find_parent<floating_element*>(ctx);
          if (fl)
          {
+            // Refresh only the area the element moved from and to
             auto p = track_info.movement();
-            fl->bounds(fl->bounds().move(p.x, p.y));
-            ctx.view.refresh();
+            auto from = fl->bounds();
+            fl->bounds(from.move(p.x, p.y));
+            ctx.view.refresh(ctx, union_(from, fl->bounds()));
          }
       }
    }
 
+   void movable_base::end_tracking(context const& ctx, tracker_info& /* track_info */)
+   {
+      if (auto cw = find_parent<child_window_element*>(ctx))
+      {
+         // Draw the window live again
+         cw->end_move();
+         ctx.view.refresh(ctx, cw->bounds());
+      }
+   }
+
    ////////////////////////////////////////////////////////////////////////////
    // closable_element
    ////////////////////////////////////////////////////////////////////////////
@@ -10,6 +10,7 @@
 #include <elements/support/context.hpp>
 #include <elements/support/theme.hpp>
 #include <elements/view.hpp>
+#include <cmath>
 
 namespace cycfi { namespace elements
 {
@@ -24,7 +25,7 @@ namespace cycfi { namespace elements
 
    namespace
    {
-      std::string address_to_string(void* p)
+      std::string address_to_string(void const* p)
       {
          return std::string(reinterpret_cast<char const*>(&p), sizeof(void*));
       }
@@ -33,19 +34,43 @@ namespace cycfi { namespace elements
    void drop_base::prepare_subject(context& ctx)
    {
       proxy_base::prepare_subject(ctx);
-      std::string id = address_to_string(this);
-      if (_mime_types.find(id) == _mime_types.end())
-         _mime_types.insert(id);
+
+      // Register our address as a pseudo MIME type, for dragging items
+      // within this element (see draggable_element). We do this only once,
+      // or when this element has been copied or moved to a new address.
+      if (_self != this)
+      {
+         if (_self)
+            _mime_types.erase(_self_key);
+         _self_key = address_to_string(this);
+         _mime_types.insert(_self_key);
+         _self = this;
+      }
+   }
+
+   mime_set const& drop_base::get_mime_ids()
+   {
+      if (!_mime_ids_valid)
+      {
+         // Our address is not a real MIME type, and is not interned (it
+         // would stay in the table forever). It is matched separately.
+         _mime_ids.clear();
+         for (auto const& mime_type : _mime_types)
+         {
+            if (mime_type != _self_key)
+               _mime_ids.insert(intern_mime_type(mime_type));
+         }
+         _mime_ids_valid = true;
+      }
+      return _mime_ids;
    }
 
    void drop_base::track_drop(context const& ctx, drop_info const& info, cursor_tracking status)
    {
       // Return early if none of registered mime types is in the `drop_info`
-      if (!std::any_of(_mime_types.begin(), _mime_types.end(),
-         [&](auto const& item)
-         {
-            return info.data.find(item) != info.data.end();
-         }))
+      bool accepts = info.data.mime_types().intersects(get_mime_ids())
+         || (!_self_key.empty() && info.data.count(_self_key));
+      if (!accepts)
          return;
 
       auto new_is_tracking = status != cursor_tracking::leaving;
@@ -92,6 +117,40 @@ namespace cycfi { namespace elements
     : base_type{mime_types_}
    {}
 
+   namespace
+   {
+      constexpr auto indicator_width = 2.0f;
+
+      // Compute the insertion position and the insertion indicator line
+      // (given as a rect with zero height) for the cursor position `p`.
+      // `cctx` is the context of the composite `c`.
+      int insertion_indicator(context const& cctx, composite_base& c, point p, rect& line)
+      {
+         if (c.size())
+         {
+            auto hit_info = c.hit_element(cctx, p, false);
+            if (hit_info.element_ptr)
+            {
+               rect const& bounds = hit_info.bounds;
+               bool before = p.y < (bounds.top + (bounds.height()/2));
+               float pos = before? bounds.top : bounds.bottom;
+               line = {bounds.left, pos, bounds.right, pos};
+               return before? hit_info.index : hit_info.index+1;
+            }
+            return -1;
+         }
+         line = {cctx.bounds.left, cctx.bounds.top, cctx.bounds.right, cctx.bounds.top};
+         return 0;
+      }
+
+      rect to_device(context const& ctx, rect r)
+      {
+         auto tl = ctx.canvas.user_to_device(r.top_left());
+         auto br = ctx.canvas.user_to_device(r.bottom_right());
+         return {tl.x, tl.y, br.x, br.y};
+      }
+   }
+
    void drop_inserter_element::draw(context const& ctx)
    {
       proxy_base::draw(ctx);
@@ -101,33 +160,16 @@ namespace cycfi { namespace elements
          {
             in_context_do(ctx, *c, [&](context const& cctx)
             {
-               point cursor_pos = ctx.cursor_pos();
-               if (c->size())
+               rect line;
+               auto pos = insertion_indicator(cctx, *c, ctx.cursor_pos(), line);
+               if (pos >= 0)
                {
-                  auto hit_info = c->hit_element(cctx, cursor_pos, false);
-                  if (hit_info.element_ptr)
-                  {
-                     rect const& bounds = hit_info.bounds;
-                     bool before = cursor_pos.y < (bounds.top + (bounds.height()/2));
-                     float pos = before? bounds.top : bounds.bottom;
-                     _insertion_pos = before? hit_info.index : hit_info.index+1;
-
-                     auto &cnv = cctx.canvas;
-                     cnv.stroke_style(get_theme().indicator_hilite_color.opacity(0.5));
-                     cnv.line_width(2.0);
-                     cnv.move_to({bounds.left, pos});
-                     cnv.line_to({bounds.right, pos});
-                     cnv.stroke();
-                  }
-               }
-               else
-               {
-                  _insertion_pos = 0;
+                  _insertion_pos = pos;
                   auto &cnv = cctx.canvas;
                   cnv.stroke_style(get_theme().indicator_hilite_color.opacity(0.5));
-                  cnv.line_width(2.0);
-                  cnv.move_to({cctx.bounds.left, cctx.bounds.top});
-                  cnv.line_to({cctx.bounds.right, cctx.bounds.top});
+                  cnv.line_width(indicator_width);
+                  cnv.move_to({line.left, line.top});
+                  cnv.line_to({line.right, line.top});
                   cnv.stroke();
                }
             });
@@ -138,12 +180,41 @@ namespace cycfi { namespace elements
    void drop_inserter_element::track_drop(context const& ctx, drop_info const& info, cursor_tracking status)
    {
       base_type::track_drop(ctx, info, status);
+
+      // Refresh only the old and new insertion indicator. The indicator is
+      // kept in device coordinates, so it stays valid across scrolls.
+      auto old_indicator = _indicator;
+      _indicator = {};
+      bool scrolled = false;
+
       if (is_tracking())
       {
          static constexpr auto offset = 20;
          rect r = {info.where.x-offset, info.where.y-offset, info.where.x+offset, info.where.y+offset};
-         scrollable::find(ctx).scroll_into_view(r);
-         ctx.view.refresh(ctx);
+         scrolled = scrollable::find(ctx).scroll_into_view(r);
+
+         if (auto c = find_subject<composite_base*>(this))
+         {
+            in_context_do(ctx, *c, [&](context const& cctx)
+            {
+               rect line;
+               auto pos = insertion_indicator(cctx, *c, ctx.cursor_pos(), line);
+               if (pos >= 0)
+               {
+                  _insertion_pos = pos;
+                  _indicator = to_device(cctx, line.inset(-indicator_width, -indicator_width));
+               }
+            });
+         }
+      }
+
+      // If we scrolled, the scroller has already refreshed everything.
+      if (!scrolled && old_indicator != _indicator)
+      {
+         if (!old_indicator.is_empty())
+            ctx.view.refresh(old_indicator);
+         if (!_indicator.is_empty())
+            ctx.view.refresh(_indicator);
       }
    }
 
@@ -194,13 +265,19 @@ namespace cycfi { namespace elements
 
    void drop_inserter_element::move(indices_type const& indices)
    {
-      if (_insertion_pos >= 0)
+      if (_insertion_pos >= 0 && !indices.empty())
       {
          if (auto* c = find_subject<list*>(&subject()))
             c->move(_insertion_pos, indices);
          on_move(_insertion_pos, indices);
+
+         // The moved items end up contiguous, starting at the insertion
+         // position less the number of moved items that were before it.
+         // No need to query the elements for their selection state.
+         auto before = std::lower_bound(indices.begin(), indices.end(), std::size_t(_insertion_pos));
+         auto first = _insertion_pos - int(before - indices.begin());
          if (auto s = find_subject<selection_list_element*>(this))
-            s->update_selection(_insertion_pos, _insertion_pos+indices.size()-1);
+            s->update_selection(first, first + int(indices.size()) - 1);
       }
    }
 
@@ -251,6 +328,10 @@ namespace cycfi { namespace elements
       constexpr auto item_offset = 10;
       constexpr auto max_boxes = 20;
 
+      // The drag image boxes overhang the drag image bounds by this much
+      constexpr auto box_overhang_x = 8;
+      constexpr auto box_overhang_y = 2;
+
       class drag_image_element : public proxy_base
       {
       public:
@@ -278,9 +359,41 @@ namespace cycfi { namespace elements
          }
 
          void draw(context const& ctx) override
+         {
+            // The drag image does not change while dragging. Render it once
+            // into an offscreen image, and simply blit that afterwards.
+            auto area = ctx.bounds.inset(-box_overhang_x, -box_overhang_y);
+            auto size = extent{area.width(), area.height()};
+            auto tl = ctx.canvas.user_to_device(area.top_left());
+            auto br = ctx.canvas.user_to_device(area.bottom_right());
+            auto scale = (br.x - tl.x) / size.x;
+
+            if (!_cache || _cache_size != size || _cache_scale != scale)
+            {
+               _cache_size = size;
+               _cache_scale = scale;
+               _cache = std::make_shared<artist::image>(
+                  extent{std::ceil(size.x * scale), std::ceil(size.y * scale)}
+               );
+
+               artist::offscreen_image offscr{*_cache};
+               canvas cnv{offscr.context()};
+               cnv.pre_scale(scale);
+               rect bounds = {
+                  box_overhang_x, box_overhang_y
+                , box_overhang_x + ctx.bounds.width(), box_overhang_y + ctx.bounds.height()
+               };
+               draw_image(context{ctx.view, cnv, this, bounds});
+            }
+            ctx.canvas.draw(*_cache, area);
+         }
+
+      private:
+
+         void draw_image(context const& ctx)
          {
             auto& canvas_ = ctx.canvas;
-            auto bounds = ctx.bounds.inset(-8, -2);
+            auto bounds = ctx.bounds.inset(-box_overhang_x, -box_overhang_y);
             bounds.right -= item_offset * _num_boxes;
             bounds.bottom -= item_offset * _num_boxes;
             float opacity = 0.6;
@@ -296,9 +409,10 @@ namespace cycfi { namespace elements
             proxy_base::draw(ctx);
          }
 
-      private:
-
          std::size_t _num_boxes = 0;
+         artist::image_ptr _cache;
+         extent _cache_size;
+         float _cache_scale = 0;
       };
 
       template <typename Subject>
@@ -317,15 +431,15 @@ namespace cycfi { namespace elements
          {
             case key_code::escape:
                {
+                  if (_drag_image)
+                     ctx.view.refresh_layers(_drag_image->bounds().inset(-box_overhang_x, -box_overhang_y));
                   ctx.view.remove(_drag_image);
                   _drag_image.reset();
                   escape_tracking(ctx);
-                  auto* di = find_parent<drop_inserter_element *>(ctx);
-                  if (di)
+                  if (find_parent<drop_inserter_element *>(ctx))
                   {
-                     payload pl;
-                     pl[address_to_string(di)] = {};
-                     ctx.view.track_drop({pl, ctx.cursor_pos()}, cursor_tracking::leaving);
+                     _drop_info.where = ctx.cursor_pos();
+                     ctx.view.track_drop(_drop_info, cursor_tracking::leaving);
                   }
                }
                break;
@@ -385,13 +499,16 @@ namespace cycfi { namespace elements
                )
             );
             ctx.view.add(_drag_image);
-            ctx.view.refresh();
+            ctx.view.refresh_layers(bounds.inset(-box_overhang_x, -box_overhang_y));
 
             if (auto* di = find_parent<drop_inserter_element *>(ctx))
             {
-               payload pl;
-               pl[address_to_string(di)] = {};
-               ctx.view.track_drop({pl, track_info.current}, cursor_tracking::entering);
+               // The drag payload is built once, here, and reused for the
+               // whole drag operation.
+               _drop_info.data.clear();
+               _drop_info.data[address_to_string(di)] = {};
+               _drop_info.where = track_info.current;
+               ctx.view.track_drop(_drop_info, cursor_tracking::entering);
             }
             track_info.processed = true;
          }
@@ -406,18 +523,22 @@ namespace cycfi { namespace elements
 
       if (_drag_image)
       {
-         _drag_image->bounds(
-            _drag_image->bounds().move_to(track_info.current.x, track_info.current.y)
-         );
+         // Refresh only the old and new drag image areas
+         auto old_bounds = _drag_image->bounds();
+         auto new_bounds = old_bounds.move_to(track_info.current.x, track_info.current.y);
+         _drag_image->bounds(new_bounds);
+         if (new_bounds != old_bounds)
+         {
+            ctx.view.refresh_layers(old_bounds.inset(-box_overhang_x, -box_overhang_y));
+            ctx.view.refresh_layers(new_bounds.inset(-box_overhang_x, -box_overhang_y));
+         }
 
-         if (auto* di = find_parent<drop_inserter_element *>(ctx))
+         if (find_parent<drop_inserter_element *>(ctx))
          {
-            payload pl;
-            pl[address_to_string(di)] = {};
-            ctx.view.track_drop({pl, track_info.current}, cursor_tracking::hovering);
+            _drop_info.where = track_info.current;
+            ctx.view.track_drop(_drop_info, cursor_tracking::hovering);
             track_info.processed = true;
          }
-         ctx.view.refresh(); // $$$ Don't be lazy $$$
       }
    }
 
@@ -434,16 +555,15 @@ namespace cycfi { namespace elements
 
       if (_drag_image)
       {
+         ctx.view.refresh_layers(_drag_image->bounds().inset(-box_overhang_x, -box_overhang_y));
          ctx.view.remove(_drag_image);
          _drag_image.reset();
-         ctx.view.refresh();
 
          auto* di = find_parent<drop_inserter_element *>(ctx);
          if (di)
          {
-            payload pl;
-            pl[address_to_string(di)] = {};
-            ctx.view.track_drop({pl, track_info.current}, cursor_tracking::leaving);
+            _drop_info.where = track_info.current;
+            ctx.view.track_drop(_drop_info, cursor_tracking::leaving);
          }
 
          // Did we actually do a drag?
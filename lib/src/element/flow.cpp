@@ -6,39 +6,268 @@
 #include <elements/element/flow.hpp>
 #include <elements/support/context.hpp>
 #include <elements/view.hpp>
+#include <algorithm>
 
 namespace cycfi { namespace elements
 {
    ////////////////////////////////////////////////////////////////////////////
-   // Flow Element
+   // Flow Lines
    ////////////////////////////////////////////////////////////////////////////
-   view_limits flow_element::limits(basic_context const& ctx) const
+   namespace
    {
-      view_limits limits_ = {{0, 0}, {full_extent, full_extent}};
-      if (!_flowable.needs_reflow())
+      // The width of an item that needs to be measured
+      constexpr float unmeasured = -1;
+   }
+
+   void flow_lines::reflow(std::size_t first, std::size_t last)
+   {
+      for (auto i = first, end = std::min(last, _widths.size()); i < end; ++i)
+         _widths[i] = unmeasured;
+      _dirty_first = std::min(_dirty_first, first);
+      _dirty_last = std::max(_dirty_last, last);
+   }
+
+   namespace
+   {
+      // Shift the range [first, last) for n items inserted at pos
+      void shift_range(std::size_t& first, std::size_t& last, std::size_t pos, std::size_t n)
+      {
+         if (first < last)
+         {
+            if (first >= pos)
+               first += n;
+            if (last > pos && last != flow_lines::npos)
+               last += n;
+         }
+      }
+
+      // Shrink the range [first, last) for n items erased at pos
+      void shrink_range(std::size_t& first, std::size_t& last, std::size_t pos, std::size_t n)
+      {
+         auto shrink = [&](std::size_t i)
+         {
+            return (i <= pos || i == flow_lines::npos)? i : (i < pos + n)? pos : i - n;
+         };
+         if (first < last)
+         {
+            first = shrink(first);
+            last = shrink(last);
+         }
+      }
+   }
+
+   void flow_lines::insert(std::size_t pos, std::size_t n)
+   {
+      // Shift the cached widths, the line breaks and the pending ranges
+      // past pos. Only the inserted items need to be measured.
+      if (n == 0 || pos > _widths.size())
+         return;
+
+      _widths.insert(_widths.begin() + pos, n, unmeasured);
+      for (auto& b : _breaks)
+      {
+         if (b > pos)
+            b += n;
+      }
+      _size += n;
+
+      shift_range(_dirty_first, _dirty_last, pos, n);
+      shift_range(_changed_first, _changed_last, pos, n);
+      reflow(pos, pos + n);
+   }
+
+   void flow_lines::erase(std::size_t pos, std::size_t n)
+   {
+      // Shift the cached widths, the line breaks and the pending ranges
+      // past pos. Nothing needs to be measured, but the lines from pos are
+      // broken again.
+      if (pos >= _widths.size())
+         return;
+      n = std::min(n, _widths.size() - pos);
+      if (n == 0)
+         return;
+
+      // The lines that started within the erased items become empty. They
+      // are kept, so that the lines are still in step with the rows made
+      // for them, and are replaced by the next break_lines.
+      _widths.erase(_widths.begin() + pos, _widths.begin() + pos + n);
+      for (auto& b : _breaks)
+      {
+         if (b > pos)
+            b = (b < pos + n)? pos : b - n;
+      }
+      _size -= std::min(_size, n);
+
+      shrink_range(_dirty_first, _dirty_last, pos, n);
+      shrink_range(_changed_first, _changed_last, pos, n);
+
+      _min_width = 0;
+      for (auto w : _widths)
+         clamp_min(_min_width, w);
+
+      _changed_first = std::min(_changed_first, pos);
+      _changed_last = std::max(_changed_last, pos + 1);
+   }
+
+   std::size_t flow_lines::line_of(std::size_t index) const
+   {
+      auto i = std::upper_bound(_breaks.begin(), _breaks.end(), index);
+      return (i == _breaks.begin())? 0 : (i - _breaks.begin()) - 1;
+   }
+
+   void flow_lines::measure(std::size_t size, measure_function f)
+   {
+      auto const old_size = _widths.size();
+      if (size != old_size)
+      {
+         // Items were added or removed at the end, or without telling us
+         // where (see insert and erase). The items past the first added or
+         // removed item may have shifted and need to be measured.
+         _widths.resize(size);
+         reflow(std::min(old_size, size));
+      }
+
+      if (!needs_reflow())
+         return;
+
+      // Measure only the items in the dirty range that are not measured.
+      // Items that were only shifted by insert or erase keep their widths.
+      auto const last = std::min(_dirty_last, size);
+      for (auto i = _dirty_first; i < last; ++i)
       {
-         limits_.min.y = base_type::limits(ctx).min.y;
+         if (_widths[i] == unmeasured)
+            _widths[i] = f(i);
+      }
+
+      _min_width = 0;
+      for (auto w : _widths)
+         clamp_min(_min_width, w);
 
-         for (std::size_t i = 0; i != _flowable.size();  ++i)
+      _changed_first = std::min(_changed_first, _dirty_first);
+      _changed_last = std::max(_changed_last, _dirty_last);
+      _dirty_first = npos;
+      _dirty_last = 0;
+   }
+
+   flow_lines::change flow_lines::break_lines(float width)
+   {
+      auto const size = _widths.size();
+      auto const old_size = _size;
+      bool const width_changed = width != _width;
+      auto const changed_first = _changed_first;
+      auto const changed_last = _changed_last;
+
+      if (!width_changed && changed_first >= changed_last)
+         return {_breaks.size(), _breaks.size(), _breaks.size()};
+
+      _width = width;
+      _size = size;
+      _changed_first = npos;
+      _changed_last = 0;
+
+      // If only some items changed, start from the line before the first
+      // changed item, since the changed item may now fit in that line.
+      std::size_t start = 0;
+      if (!width_changed && !_breaks.empty())
+      {
+         start = line_of(changed_first);
+         while (start && _breaks[start-1] == _breaks[start])
+            --start;    // Empty lines left by erase
+         if (start)
+            --start;
+      }
+
+      std::vector<std::size_t> breaks(_breaks.begin(), _breaks.begin() + start);
+      auto const from = (start < _breaks.size())? _breaks[start] : 0;
+      if (from < size)
+         breaks.push_back(from);
+
+      change r;
+      r.last = npos;
+      auto old = _breaks.begin() + start;
+      double x = 0;
+      for (auto i = from; i < size; ++i)
+      {
+         x += _widths[i];
+         if (x > width && i != breaks.back())
          {
-            auto el = _flowable.at(i).limits(ctx);
-            clamp_min(limits_.min.x, el.min.x);
+            // Past the changed items, the lines are the same as before once
+            // a new line starts at an old line break.
+            if (!width_changed && i >= changed_last)
+            {
+               old = std::lower_bound(old, _breaks.end(), i);
+               if (old != _breaks.end() && *old == i)
+               {
+                  r.last = breaks.size();
+                  r.old_last = old - _breaks.begin();
+                  breaks.insert(breaks.end(), old, _breaks.end());
+                  break;
+               }
+            }
+            breaks.push_back(i);
+            x = _widths[i];
          }
       }
-      return limits_;
+
+      if (r.last == npos)
+      {
+         r.last = breaks.size();
+         r.old_last = _breaks.size();
+      }
+
+      // Skip the leading lines that did not change at all
+      auto end_of = [](std::vector<std::size_t> const& b, std::size_t line, std::size_t n)
+      {
+         return (line + 1 < b.size())? b[line + 1] : n;
+      };
+
+      r.first = start;
+      while (r.first < r.last && r.first < r.old_last
+         && breaks[r.first] == _breaks[r.first]
+         && end_of(breaks, r.first, size) == end_of(_breaks, r.first, old_size)
+         && end_of(breaks, r.first, size) <= changed_first)
+      {
+         ++r.first;
+      }
+
+      _breaks = std::move(breaks);
+      return r;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Flow Element
+   ////////////////////////////////////////////////////////////////////////////
+   view_limits flow_row::limits(basic_context const& ctx) const
+   {
+      if (!_limits_valid)
+      {
+         _limits = base_type::limits(ctx);
+         _limits_valid = true;
+      }
+      return _limits;
+   }
+
+   view_limits flow_element::limits(basic_context const& ctx) const
+   {
+      if (!_flowable.needs_reflow())
+      {
+         _limits.min.y = base_type::limits(ctx).min.y;
+         _limits.min.x = _flowable.min_width();
+      }
+      return _limits;
    }
 
    void flow_element::layout(context const& ctx)
    {
-      clear();
       _flowable.break_lines(*this, ctx, ctx.bounds.width());
       base_type::layout(ctx);
 
-      if (_flowable.needs_reflow())
-      {
+      // Our limits depend on the lines. Lay out the view again only if
+      // these changed.
+      auto const prev = _limits;
+      limits(ctx);
+      if (prev.min.x != _limits.min.x || prev.min.y != _limits.min.y)
          ctx.view.post([&view = ctx.view]{ view.layout(); });
-         _flowable.reflow_done();
-      }
    }
 
    void flowable_container::break_lines(
@@ -47,27 +276,41 @@ namespace cycfi { namespace elements
     , float width
    )
    {
-      double      curr_x = 0;
-      std::size_t first = 0;
-      std::size_t last = 0;
+      _lines.measure(size(), [&](std::size_t i) { return width_of(i, ctx); });
+      auto r = _lines.break_lines(width);
 
-      for (std::size_t ix = 0; ix != size();  ++ix)
-      {
-         double   elem_nat_x = width_of(ix, ctx);
-         curr_x = curr_x + elem_nat_x;
+      // The rows should be in step with the old lines. If not, make all
+      // the rows again.
+      auto const num_lines = _lines.num_lines();
+      if (rows.size() != num_lines - r.last + r.old_last)
+         r = {0, num_lines, rows.size()};
+
+      if (r.empty())
+         return;
 
-         if (curr_x > width)
+      // Replace the rows of the changed lines, reusing the rows that still
+      // have the same range of items.
+      std::vector<element_ptr> changed;
+      changed.reserve(r.last - r.first);
+      for (auto line = r.first; line != r.last; ++line)
+      {
+         auto const first = _lines.first(line);
+         auto const last = _lines.last(line);
+         if (line < r.old_last)
          {
-            curr_x = elem_nat_x;
-            rows.push_back(make_row(first, last));
-            first = last;
+            auto row = std::dynamic_pointer_cast<flow_row>(rows[line]);
+            if (row && row->first() == first && row->last() == last)
+            {
+               row->invalidate();
+               changed.push_back(row);
+               continue;
+            }
          }
-
-         last++;
+         changed.push_back(make_row(first, last));
       }
 
-      if (first != last)
-         rows.push_back(make_row(first, last));
+      rows.erase(rows.begin() + r.first, rows.begin() + r.old_last);
+      rows.insert(rows.begin() + r.first, changed.begin(), changed.end());
    }
 
    float flowable_container::width_of(size_t index, basic_context const& ctx) const
@@ -77,7 +320,95 @@ namespace cycfi { namespace elements
 
    element_ptr flowable_container::make_row(size_t first, size_t last)
    {
-      using htile = range_composite<htile_element>;
-      return std::make_shared<htile>(*this, first, last);
+      return std::make_shared<flow_row>(*this, first, last);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Flow Cell Composer
+   ////////////////////////////////////////////////////////////////////////////
+   void flow_cell_composer::measure(basic_context const& ctx) const
+   {
+      auto& c = *_composer;
+      _heights.resize(c.size());
+      _lines.measure(c.size(),
+         [&](std::size_t i)
+         {
+            _heights[i] = c.height_of(i, ctx);
+            return c.width_of(i, ctx);
+         }
+      );
+   }
+
+   std::size_t flow_cell_composer::size() const
+   {
+      return _lines.num_lines();
+   }
+
+   element_ptr flow_cell_composer::compose(std::size_t line)
+   {
+      using row_type = vector_composite<htile_element>;
+
+      auto row = std::make_shared<row_type>();
+      auto const first = _lines.first(line);
+      auto const last = _lines.last(line);
+      row->reserve(last - first);
+      for (auto i = first; i != last; ++i)
+         row->push_back(_composer->compose(i));
+      return row;
+   }
+
+   cell_composer::limits flow_cell_composer::secondary_axis_limits(basic_context const& ctx) const
+   {
+      measure(ctx);
+      return {_lines.min_width(), full_extent};
+   }
+
+   float flow_cell_composer::main_axis_size(std::size_t line, basic_context const& /* ctx */) const
+   {
+      float height = 0;
+      for (auto i = _lines.first(line), last = _lines.last(line); i != last; ++i)
+         clamp_min(height, _heights[i]);
+      return height;
+   }
+
+   flow_lines::change flow_cell_composer::break_lines(basic_context const& ctx, float width)
+   {
+      measure(ctx);
+      return _lines.break_lines(width);
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Flow List
+   ////////////////////////////////////////////////////////////////////////////
+   void flow_list::layout(context const& ctx)
+   {
+      // Sync the cells with the current lines first
+      auto const prev = limits(ctx);
+
+      auto const r = _flow_composer->break_lines(ctx, ctx.bounds.width());
+      if (!r.empty())
+      {
+         auto const num_lines = _flow_composer->size();
+         if (_cells.size() != num_lines - r.last + r.old_last)
+         {
+            update();
+         }
+         else
+         {
+            // Replace only the cells of the lines that changed. The cells
+            // past these may have moved, so lay them out again when drawn.
+            _cells.erase(_cells.begin() + r.first, _cells.begin() + r.old_last);
+            _cells.insert(_cells.begin() + r.first, r.last - r.first, cell_info{});
+            for (auto i = r.first; i != r.last; ++i)
+               _cells[i].main_axis_size = _flow_composer->main_axis_size(i, ctx);
+            for (auto i = r.last; i < _cells.size(); ++i)
+               _cells[i].layout_id = -1;
+            update_positions(r.first);
+         }
+
+         if (limits(ctx).min.y != prev.min.y)
+            ctx.view.post([&view = ctx.view]{ view.layout(); });
+      }
+      list::layout(ctx);
    }
 }}
@@ -14,9 +14,11 @@ namespace cycfi { namespace elements
       draw_button(ctx.canvas, bounds, color_, enabled, corner_radius);
    }
 
-   bool button_styler_base::cursor(context const& ctx, point /*p*/, cursor_tracking /*status*/)
+   bool button_styler_base::cursor(context const& ctx, point /*p*/, cursor_tracking status)
    {
-      ctx.view.refresh(ctx);
+      // Nothing visible changes while merely hovering
+      if (status != cursor_tracking::hovering)
+         ctx.view.refresh(ctx);
       return true;
    }
 
@@ -25,22 +27,58 @@ namespace cycfi { namespace elements
       return true;
    }
 
+   default_button_styler::measure_cache const&
+   default_button_styler::measure(canvas& cnv) const
+   {
+      auto thm = get_theme_ptr();
+      auto const& theme = *thm;
+      auto rel_size = get_size();
+      auto text = get_text();
+      auto font = theme.label_font;
+      auto font_size = font._size * rel_size;
+
+      if (thm != _measure.theme)
+      {
+         _measure = {};
+         _measure.theme = std::move(thm);
+      }
+
+      if (font_size != _measure.font_size || text != _measure.text)
+      {
+         _measure.text_size = measure_text(cnv, text, font.size(font_size));
+         _measure.text = std::string{text};
+         _measure.font_size = font_size;
+      }
+
+      if (get_icon_placement() != icon_none)
+      {
+         auto icon = get_icon();
+         auto icon_font_size = rel_size * theme.icon_font._size;
+         if (icon_font_size != _measure.icon_font_size || icon != _measure.icon)
+         {
+            _measure.icon_size = measure_icon(cnv, icon, icon_font_size);
+            _measure.icon = icon;
+            _measure.icon_font_size = icon_font_size;
+         }
+      }
+      return _measure;
+   }
+
    view_limits default_button_styler::limits(basic_context const& ctx) const
    {
       auto const& theme = get_theme();
       auto margin = get_margin();
       auto rel_size = get_size();
       auto space = theme.button_text_icon_space * rel_size;
-      auto font = theme.label_font;
-      auto& cnv = ctx.canvas;
 
       // Measure the text width
-      auto size = measure_text(cnv, get_text(), font.size(font._size * rel_size));
+      auto const& m = measure(ctx.canvas);
+      auto size = m.text_size;
 
       // Add space for the icon if necessary
       if (get_icon_placement() != icon_none)
       {
-         auto icon_size = measure_icon(cnv, get_icon(), rel_size * theme.icon_font._size);
+         auto icon_size = m.icon_size;
          size.x += icon_size.x + space;
          size.y = std::max(size.y, icon_size.y);
       }
@@ -86,15 +124,15 @@ namespace cycfi { namespace elements
       font = font.size(font._size * rel_size);
 
       // Measure text and icon
-      auto text_size = measure_text(ctx.canvas, get_text(), font);
+      auto const& m = measure(cnv);
+      auto text_size = m.text_size;
 
       // Add space for the icon if necessary
       auto icon_width = 0.0f;
       auto icon_space = 0.0f;
       if (get_icon_placement() != icon_none)
       {
-         auto icon_size = measure_icon(cnv, get_icon(), rel_size * theme.icon_font._size);
-         icon_width += icon_size.x;
+         icon_width += m.icon_size.x;
          icon_space = icon_width + space;
       }
 
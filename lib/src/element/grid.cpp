@@ -4,29 +4,126 @@
    Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
 =============================================================================*/
 #include <elements/element/grid.hpp>
+#include <elements/element/port.hpp>
 #include <elements/support/context.hpp>
+#include <elements/view.hpp>
+#include <algorithm>
 
 namespace cycfi { namespace elements
 {
+   ////////////////////////////////////////////////////////////////////////////
+   // Grid Base
+   ////////////////////////////////////////////////////////////////////////////
+   std::size_t grid_base::compute_spans(grid_index_vector& grid_index) const
+   {
+      // grid_index[i] is the index of the grid coordinate at the end of
+      // element i. Returns the total number of spans.
+      grid_index.resize(size());
+      std::size_t gi = 0;
+      for (std::size_t i = 0; i != size(); ++i)
+      {
+         gi += at(i).span();
+         grid_index[i] = gi-1;
+      }
+      return gi;
+   }
+
+   namespace
+   {
+      // Given the positions of the elements along the grid's axis, relative
+      // to the grid's start, returns the range of elements [first, last)
+      // that overlap [start, end).
+      std::pair<std::size_t, std::size_t>
+      overlapping(std::vector<float> const& positions, float start, float end)
+      {
+         auto first = std::upper_bound(positions.begin()+1, positions.end(), start);
+         auto last = std::lower_bound(positions.begin(), positions.end()-1, end);
+         return {
+            std::size_t(first - (positions.begin()+1))
+          , std::size_t(last - positions.begin())
+         };
+      }
+
+      // Returns the element whose span contains pos
+      std::size_t element_at(std::vector<float> const& positions, float pos)
+      {
+         return std::upper_bound(positions.begin()+1, positions.end(), pos)
+            - (positions.begin()+1);
+      }
+
+      template <typename Grid, typename F>
+      void for_each_in(
+         Grid const& grid
+       , context const& ctx
+       , rect const& port_bounds
+       , std::size_t first
+       , std::size_t last
+       , F&& f
+       , bool reverse
+      )
+      {
+         if (reverse)
+         {
+            for (auto i = last; i-- > first;)
+            {
+               rect bounds = grid.bounds_of(ctx, i);
+               if (intersects(bounds, port_bounds) && f(grid.at(i), i, bounds))
+                  break;
+            }
+         }
+         else
+         {
+            for (auto i = first; i < last; ++i)
+            {
+               rect bounds = grid.bounds_of(ctx, i);
+               if (intersects(bounds, port_bounds) && f(grid.at(i), i, bounds))
+                  break;
+            }
+         }
+      }
+
+      template <typename Grid>
+      composite_base::hit_info hit_element_at(
+         Grid const& grid
+       , context const& ctx
+       , std::size_t i
+       , point p
+       , bool control
+      )
+      {
+         if (i < grid.size())
+         {
+            auto& e = grid.at(i);
+            rect bounds = grid.bounds_of(ctx, i);
+            if ((!control || e.wants_control()) && bounds.includes(p))
+            {
+               context ectx{ctx, &e, bounds};
+               if (auto leaf = e.hit_test(ectx, p, true, control))
+                  return {&e, leaf, bounds, int(i)};
+            }
+         }
+         return {};
+      }
+   }
+
    ////////////////////////////////////////////////////////////////////////////
    // Vertical Grids
    ////////////////////////////////////////////////////////////////////////////
    view_limits vgrid_element::limits(basic_context const& ctx) const
    {
-      _num_spans = 0;
-      for (std::size_t i = 0; i != size(); ++i)
-         _num_spans += at(i).span();
+      if (_limits_pass == ctx.view.layout_pass() && _grid_index.size() == size())
+         return _limits;
+
+      _num_spans = compute_spans(_grid_index);
 
       view_limits limits{{0.0, 0.0}, {full_extent, 0.0}};
-      std::size_t gi = 0;
       float prev = 0;
       float desired_total_min = 0;
 
       for (std::size_t i = 0; i != size();  ++i)
       {
          auto& elem = at(i);
-         gi += elem.span()-1;
-         auto y = grid_coord(gi++);
+         auto y = grid_coord(_grid_index[i]);
          auto height = y - prev;
          auto factor = 1.0/height;
          prev = y;
@@ -44,24 +141,28 @@ namespace cycfi { namespace elements
       limits.min.y = desired_total_min;
       clamp_min(limits.max.x, limits.min.x);
       clamp_max(limits.max.y, full_extent);
+
+      _limits = limits;
+      _limits_pass = ctx.view.layout_pass();
       return limits;
    }
 
    void vgrid_element::layout(context const& ctx)
    {
+      if (_limits_pass != ctx.view.layout_pass() || _grid_index.size() != size())
+         _num_spans = compute_spans(_grid_index);
+
       _positions.resize(size()+1);
 
       auto left = ctx.bounds.left;
       auto right = ctx.bounds.right;
       auto total_height = ctx.bounds.height();
-      std::size_t gi = 0;
 
       float prev = 0;
       for (std::size_t i = 0; i != size(); ++i)
       {
          auto& elem = at(i);
-         gi += elem.span()-1;
-         auto y = grid_coord(gi++) * total_height;
+         auto y = grid_coord(_grid_index[i]) * total_height;
          auto height = y - prev;
          rect ebounds = {left, prev, right, prev+height};
          elem.layout(context{ctx, &elem, ebounds});
@@ -81,25 +182,46 @@ namespace cycfi { namespace elements
       return {left, _positions[index]+top, right, _positions[index+1]+top};
    }
 
+   void vgrid_element::for_each_visible(
+      context const& ctx
+    , for_each_callback f
+    , bool reverse
+   ) const
+   {
+      auto port_bounds = get_port_bounds(ctx);
+      if (_positions.size() != size()+1 || !intersects(ctx.bounds, port_bounds))
+         return;
+
+      auto top = ctx.bounds.top;
+      auto [first, last] = overlapping(_positions, port_bounds.top-top, port_bounds.bottom-top);
+      for_each_in(*this, ctx, port_bounds, first, last, f, reverse);
+   }
+
+   composite_base::hit_info vgrid_element::hit_element(context const& ctx, point p, bool control) const
+   {
+      if (_positions.size() != size()+1)
+         return {};
+      return hit_element_at(*this, ctx, element_at(_positions, p.y-ctx.bounds.top), p, control);
+   }
+
    ////////////////////////////////////////////////////////////////////////////
    // Horizontal Grids
    ////////////////////////////////////////////////////////////////////////////
    view_limits hgrid_element::limits(basic_context const& ctx) const
    {
-      _num_spans = 0;
-      for (std::size_t i = 0; i != size(); ++i)
-         _num_spans += at(i).span();
+      if (_limits_pass == ctx.view.layout_pass() && _grid_index.size() == size())
+         return _limits;
+
+      _num_spans = compute_spans(_grid_index);
 
       view_limits limits{{ 0.0, 0.0}, {0.0, full_extent}};
-      std::size_t gi = 0;
       float prev = 0;
       float desired_total_min = 0;
 
       for (std::size_t i = 0; i != size();  ++i)
       {
          auto& elem = at(i);
-         gi += elem.span()-1;
-         auto x = grid_coord(gi++);
+         auto x = grid_coord(_grid_index[i]);
          auto width = x - prev;
          auto factor = 1.0/width;
          prev = x;
@@ -117,24 +239,28 @@ namespace cycfi { namespace elements
       limits.min.x = desired_total_min;
       clamp_min(limits.max.y, limits.min.y);
       clamp_max(limits.max.x, full_extent);
+
+      _limits = limits;
+      _limits_pass = ctx.view.layout_pass();
       return limits;
    }
 
    void hgrid_element::layout(context const& ctx)
    {
+      if (_limits_pass != ctx.view.layout_pass() || _grid_index.size() != size())
+         _num_spans = compute_spans(_grid_index);
+
       _positions.resize(size()+1);
 
       auto top = ctx.bounds.top;
       auto bottom = ctx.bounds.bottom;
       auto total_width = ctx.bounds.width();
-      std::size_t gi = 0;
 
       float prev = 0;
       for (std::size_t i = 0; i != size(); ++i)
       {
          auto& elem = at(i);
-         gi += elem.span()-1;
-         auto x = grid_coord(gi++) * total_width;
+         auto x = grid_coord(_grid_index[i]) * total_width;
          auto width = x - prev;
          rect ebounds = {prev, top, prev+width, bottom};
          elem.layout(context{ctx, &elem, ebounds});
@@ -153,4 +279,26 @@ namespace cycfi { namespace elements
       auto bottom = ctx.bounds.bottom;
       return {_positions[index]+left, top, _positions[index+1]+left, bottom};
    }
+
+   void hgrid_element::for_each_visible(
+      context const& ctx
+    , for_each_callback f
+    , bool reverse
+   ) const
+   {
+      auto port_bounds = get_port_bounds(ctx);
+      if (_positions.size() != size()+1 || !intersects(ctx.bounds, port_bounds))
+         return;
+
+      auto left = ctx.bounds.left;
+      auto [first, last] = overlapping(_positions, port_bounds.left-left, port_bounds.right-left);
+      for_each_in(*this, ctx, port_bounds, first, last, f, reverse);
+   }
+
+   composite_base::hit_info hgrid_element::hit_element(context const& ctx, point p, bool control) const
+   {
+      if (_positions.size() != size()+1)
+         return {};
+      return hit_element_at(*this, ctx, element_at(_positions, p.x-ctx.bounds.left), p, control);
+   }
 }}
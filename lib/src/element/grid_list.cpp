@@ -0,0 +1,233 @@
+/*=============================================================================
+   Copyright (c) 2016-2023 Joel de Guzman
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#include <elements/element/grid_list.hpp>
+#include <elements/element/port.hpp>
+#include <elements/view.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace cycfi { namespace elements
+{
+   grid_list::grid_list(
+      composer_ptr composer
+    , float aspect_ratio
+    , bool manage_externally
+   )
+    : _composer(composer)
+    , _recycler(dynamic_cast<recycling_cell_composer*>(composer.get()))
+    , _aspect_ratio(aspect_ratio)
+    , _manage_externally(manage_externally)
+   {}
+
+   std::size_t grid_list::size() const
+   {
+      return _composer? _composer->size() : 0;
+   }
+
+   std::size_t grid_list::rows() const
+   {
+      return _columns? (size() + _columns - 1) / _columns : 0;
+   }
+
+   element& grid_list::at(std::size_t ix) const
+   {
+      auto& cell = _cells[ix];
+      if (!cell.elem_ptr)
+      {
+         if (_recycler && !_recycled.empty())
+         {
+            cell.elem_ptr = _recycler->recompose(ix, std::move(_recycled.back()));
+            _recycled.pop_back();
+         }
+         else
+         {
+            cell.elem_ptr = _composer->compose(ix);
+         }
+      }
+      return *cell.elem_ptr;
+   }
+
+   view_limits grid_list::limits(basic_context const& ctx) const
+   {
+      if (!_composer)
+         return {{0, 0}, {0, 0}};
+
+      auto const cell_limits = _composer->secondary_axis_limits(ctx);
+      auto const height = float(rows() * double(_cell_height));
+      return {{cell_limits.min, height}, {full_extent, height}};
+   }
+
+   void grid_list::layout(context const& ctx)
+   {
+      if (!_composer)
+         return;
+
+      auto const width = ctx.bounds.width();
+      auto const cell_limits = _composer->secondary_axis_limits(ctx);
+      auto const prev_height = rows() * double(_cell_height);
+
+      std::size_t columns = 1;
+      if (cell_limits.min > 0)
+         columns = std::max<std::size_t>(1, std::size_t(width / cell_limits.min));
+
+      auto const cell_width = std::min(width / columns, cell_limits.max);
+      auto cell_height = cell_width * _aspect_ratio;
+      if (_aspect_ratio <= 0)
+         cell_height = size()? _composer->main_axis_size(0, ctx) : 0;
+
+      if (columns != _columns || cell_width != _cell_width || cell_height != _cell_height)
+      {
+         _columns = columns;
+         _cell_width = cell_width;
+         _cell_height = cell_height;
+         ++_layout_id;
+      }
+
+      // Our height depends on the number of columns. Lay out the view again
+      // only if it changed.
+      if (rows() * double(_cell_height) != prev_height)
+         ctx.view.post([&view = ctx.view]{ view.layout(); });
+   }
+
+   void grid_list::visible_range(
+      context const& ctx
+    , rect const& visible
+    , std::size_t& first
+    , std::size_t& last
+   ) const
+   {
+      first = last = 0;
+      if (!_columns || _cell_height <= 0 || !intersects(ctx.bounds, visible))
+         return;
+
+      auto const top = ctx.bounds.top;
+      auto const first_row = std::max(0.0f, std::floor((visible.top - top) / _cell_height));
+      auto const last_row = std::max(0.0f, std::ceil((visible.bottom - top) / _cell_height));
+      first = std::min(std::size_t(first_row) * _columns, size());
+      last = std::min(std::size_t(last_row) * _columns, size());
+   }
+
+   rect grid_list::bounds_of(context const& ctx, std::size_t ix) const
+   {
+      if (!_columns)
+         return {};
+      auto const left = ctx.bounds.left + (ix % _columns) * double(_cell_width);
+      auto const top = ctx.bounds.top + (ix / _columns) * double(_cell_height);
+      return rect{
+         float(left), float(top)
+       , float(left + _cell_width), float(top + _cell_height)
+      };
+   }
+
+   std::size_t grid_list::index_of(context const& ctx, point p) const
+   {
+      if (!_columns || _cell_width <= 0 || _cell_height <= 0)
+         return size();
+
+      auto const x = std::max(0.0f, p.x - ctx.bounds.left);
+      auto const y = std::max(0.0f, p.y - ctx.bounds.top);
+      auto const col = std::min(std::size_t(x / _cell_width), _columns - 1);
+      auto const row = std::size_t(y / _cell_height);
+      return std::min(row * _columns + col, size());
+   }
+
+   void grid_list::draw(context const& ctx)
+   {
+      auto const clip_extent = ctx.canvas.clip_extent();
+      std::size_t first, last;
+      visible_range(ctx, clip_extent, first, last);
+
+      for (auto i = first; i != last; ++i)
+      {
+         auto bounds = bounds_of(ctx, i);
+         if (!intersects(clip_extent, bounds))
+            continue;
+
+         auto& e = at(i);
+         auto& cell = _cells[i];
+         context ectx{ctx, &e, bounds};
+         if (cell.layout_id != _layout_id)
+         {
+            e.layout(ectx);
+            cell.layout_id = _layout_id;
+         }
+         e.draw(ectx);
+      }
+
+      // Release the cells outside the port, not the clip extent, which may
+      // be just a part of the visible cells.
+      if (_manage_externally)
+      {
+         visible_range(ctx, get_port_bounds(ctx), first, last);
+         release(first, last);
+      }
+   }
+
+   void grid_list::release(std::size_t first, std::size_t last)
+   {
+      for (auto i = _cells.begin(); i != _cells.end();)
+      {
+         if (i->first < first || i->first >= last)
+         {
+            if (_recycler && i->second.elem_ptr)
+               _recycled.push_back(std::move(i->second.elem_ptr));
+            i = _cells.erase(i);
+         }
+         else
+         {
+            ++i;
+         }
+      }
+
+      // There's no need to keep more recycled elements than there are
+      // visible cells.
+      if (_recycled.size() > last - first)
+         _recycled.resize(last - first);
+   }
+
+   void grid_list::for_each_visible(
+      context const& ctx
+    , for_each_callback f
+    , bool reverse
+   ) const
+   {
+      auto const port_bounds = get_port_bounds(ctx);
+      std::size_t first, last;
+      visible_range(ctx, port_bounds, first, last);
+
+      if (reverse)
+      {
+         for (auto i = last; i-- != first;)
+         {
+            auto bounds = bounds_of(ctx, i);
+            if (intersects(port_bounds, bounds) && f(at(i), i, bounds))
+               break;
+         }
+      }
+      else
+      {
+         for (auto i = first; i != last; ++i)
+         {
+            auto bounds = bounds_of(ctx, i);
+            if (intersects(port_bounds, bounds) && f(at(i), i, bounds))
+               break;
+         }
+      }
+   }
+
+   void grid_list::update()
+   {
+      _cells.clear();
+      _recycled.clear();
+      ++_layout_id;
+   }
+
+   void grid_list::resize(std::size_t n)
+   {
+      _composer->resize(n);
+      update();
+   }
+}}
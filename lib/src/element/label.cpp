@@ -8,9 +8,51 @@
 
 namespace cycfi { namespace elements
 {
+   namespace
+   {
+      bool same_font(font_descr const& a, font_descr const& b)
+      {
+         return a._families == b._families
+            && a._size == b._size
+            && a._weight == b._weight
+            && a._slant == b._slant
+            && a._stretch == b._stretch
+            ;
+      }
+   }
+
+   default_label::glyph_run::glyph_run(label_text text_, font_descr descr_, artist::font font_)
+    : text{std::move(text_)}
+    , descr{descr_}
+    , font{std::move(font_)}
+    , layout{font, text.view()}
+   {
+      // A label is a single line. Its size is taken from the layout, so
+      // the text is not shaped again to measure it.
+      layout.flow(full_extent);
+      auto  m = font.metrics();
+      size = {layout.caret_point(layout.text().size()).x, m.ascent + m.descent + m.leading};
+   }
+
+   default_label::glyph_run const& default_label::get_run(basic_context const& /* ctx */) const
+   {
+      auto font = get_font().size(get_font_size());
+      if (_run && same_font(_run->descr, font))
+      {
+         // Only the text may have changed
+         if (_run->text.view() != get_text())
+            _run = std::make_shared<glyph_run>(get_label_text(), font, _run->font);
+      }
+      else
+      {
+         _run = std::make_shared<glyph_run>(get_label_text(), font, artist::font{font});
+      }
+      return *_run;
+   }
+
    view_limits default_label::limits(basic_context const& ctx) const
    {
-      auto  size = measure_text(ctx.canvas, get_text(), get_font().size(get_font_size()));
+      auto  size = get_run(ctx).size;
       return {{size.x, size.y}, {size.x, size.y}};
    }
 
@@ -28,10 +70,12 @@ namespace cycfi { namespace elements
       if (!is_enabled())
          text_c = text_c.opacity(text_c.alpha * get_theme().disabled_opacity);
 
-      canvas_.fill_style(text_c);
-      canvas_.font(get_font().size(get_font_size()));
+      auto const& run = get_run(ctx);
+      auto  width = run.size.x;
+      auto  m = run.font.metrics();
 
-      float cx = ctx.bounds.left + (ctx.bounds.width() / 2);
+      // The glyph run is drawn from the left, at the baseline
+      float cx = ctx.bounds.left + ((ctx.bounds.width() - width) / 2);
       switch (align & 0x3)
       {
          case canvas::left:
@@ -40,25 +84,27 @@ namespace cycfi { namespace elements
          case canvas::center:
             break;
          case canvas::right:
-            cx = ctx.bounds.right;
+            cx = ctx.bounds.right - width;
             break;
       }
 
-      float cy = ctx.bounds.top + (ctx.bounds.height() / 2);
+      float cy = ctx.bounds.top + (ctx.bounds.height() / 2) + ((m.ascent - m.descent) / 2);
       switch (align & 0x1C)
       {
          case canvas::top:
-            cy = ctx.bounds.top;
+            cy = ctx.bounds.top + m.ascent;
             break;
          case canvas::middle:
             break;
          case canvas::bottom:
-            cy = ctx.bounds.bottom;
+            cy = ctx.bounds.bottom - m.descent;
+            break;
+         case canvas::baseline:
+            cy = ctx.bounds.top + (ctx.bounds.height() / 2);
             break;
       }
 
-      canvas_.text_align(align);
-      canvas_.fill_text(get_text(), point{cx, cy});
+      run.layout.draw(canvas_, point{cx, cy}, text_c);
    }
 
    void default_label::enable(bool state)
@@ -4,6 +4,8 @@
    Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
 =============================================================================*/
 #include <elements/element/layer.hpp>
+#include <elements/element/floating.hpp>
+#include <elements/element/traversal.hpp>
 #include <elements/view.hpp>
 #include <elements/support/context.hpp>
 
@@ -40,6 +42,60 @@ namespace cycfi { namespace elements
       }
    }
 
+   namespace
+   {
+      // Subtract `r` from each of the disjoint rects in `pieces`. The
+      // remaining pieces are still disjoint.
+      void subtract(std::vector<rect>& pieces, rect r)
+      {
+         std::vector<rect> result;
+         for (auto const& p : pieces)
+         {
+            if (!intersects(p, r))
+            {
+               result.push_back(p);
+               continue;
+            }
+
+            auto top = std::max(p.top, r.top);
+            auto bottom = std::min(p.bottom, r.bottom);
+            rect const rest[] = {
+               {p.left, p.top, p.right, top}          // Above r
+             , {p.left, bottom, p.right, p.bottom}    // Below r
+             , {p.left, top, r.left, bottom}          // Left of r
+             , {r.right, top, p.right, bottom}        // Right of r
+            };
+            for (auto const& q : rest)
+            {
+               if (q.left < q.right && q.top < q.bottom)
+                  result.push_back(q);
+            }
+         }
+         pieces.swap(result);
+      }
+   }
+
+   layer_element::floating_vector const& layer_element::floating() const
+   {
+      // Comparing the element addresses is enough to tell if elements were
+      // added, removed or replaced. Only then do we search them again.
+      bool changed = _floating.size() != size();
+      for (std::size_t ix = 0; !changed && ix != size(); ++ix)
+         changed = _floating[ix].first != &at(ix);
+
+      if (changed)
+      {
+         _floating.clear();
+         _floating.reserve(size());
+         for (std::size_t ix = 0; ix != size(); ++ix)
+         {
+            auto* e = const_cast<element*>(&at(ix));
+            _floating.emplace_back(e, find_element<floating_element*>(e));
+         }
+      }
+      return _floating;
+   }
+
    void layer_element::draw(context const& ctx)
    {
       auto width = ctx.bounds.width();
@@ -50,7 +106,56 @@ namespace cycfi { namespace elements
          _previous_size.y = height;
          layout(ctx);
       }
-      composite_base::draw(ctx);
+
+      // Opaque floating elements (e.g. cached child windows) hide what is
+      // below them. These are clipped out when drawing the elements below.
+      std::vector<std::pair<std::size_t, rect>> opaque;
+      auto const& fls = floating();
+      for (std::size_t ix = 0; ix != fls.size(); ++ix)
+      {
+         auto fl = fls[ix].second;
+         if (fl && fl->is_opaque())
+            opaque.emplace_back(ix, fl->bounds());
+      }
+
+      if (opaque.empty())
+      {
+         composite_base::draw(ctx);
+         return;
+      }
+
+      for_each_visible(ctx,
+         [&](element& e, std::size_t ix, rect const& bounds)
+         {
+            // The visible part of the element is its bounds less the union
+            // of the opaque elements above it, as a set of disjoint rects.
+            std::vector<rect> visible{bounds};
+            bool clip = false;
+            for (auto const& [above, r] : opaque)
+            {
+               if (above > ix && intersects(r, bounds))
+               {
+                  subtract(visible, r);
+                  clip = true;
+               }
+            }
+            if (clip && visible.empty())
+               return false;  // Completely hidden
+
+            auto state = ctx.canvas.new_state();
+            if (clip)
+            {
+               ctx.canvas.begin_path();
+               for (auto const& r : visible)
+                  ctx.canvas.add_rect(r);
+               ctx.canvas.clip();
+            }
+
+            context ectx{ctx, &e, bounds};
+            e.draw(ectx);
+            return false;
+         }
+      );
    }
 
    layer_element::hit_info layer_element::hit_element(context const& ctx, point p, bool control) const
@@ -13,9 +13,6 @@ namespace cycfi { namespace elements
     : _composer(composer)
     , _manage_externally(manage_externally)
     , _update_request{true}
-    , _move_request{false}
-    , _insert_request{false}
-    , _erase_request{false}
    {}
 
    list::list(list const& rhs)
@@ -28,10 +25,6 @@ namespace cycfi { namespace elements
     , _main_axis_full_size{rhs._main_axis_full_size}
     , _layout_id{rhs._layout_id}
     , _update_request{true}
-    , _move_request{false}
-    , _insert_request{false}
-    , _erase_request{false}
-    , _request_info{nullptr}
    {}
 
    list::list(list&& rhs)
@@ -44,10 +37,6 @@ namespace cycfi { namespace elements
     , _main_axis_full_size{rhs._main_axis_full_size}
     , _layout_id{rhs._layout_id}
     , _update_request{true}
-    , _move_request{false}
-    , _insert_request{false}
-    , _erase_request{false}
-    , _request_info{nullptr}
    {}
 
    list& list::operator=(list const& rhs)
@@ -63,10 +52,7 @@ namespace cycfi { namespace elements
          _main_axis_full_size = rhs._main_axis_full_size;
          _layout_id = rhs._layout_id;
          _update_request = true;
-         _move_request = false;
-         _insert_request = false;
-         _erase_request = false;
-         _request_info.reset();
+         _requests.clear();
       }
       return *this;
    }
@@ -84,21 +70,20 @@ namespace cycfi { namespace elements
          _main_axis_full_size = rhs._main_axis_full_size;
          _layout_id = rhs._layout_id;
          _update_request = true;
-         _move_request = false;
-         _insert_request = false;
-         _erase_request = false;
-         _request_info.reset();
+         _requests.clear();
       }
       return *this;
    }
 
    std::size_t list::size() const
    {
+      apply_requests();
       return _cells.size();
    }
 
    element& list::at(std::size_t ix) const
    {
+      apply_requests();
       if (_cells[ix].elem_ptr)
          return *_cells[ix].elem_ptr.get();
       return *(_cells[ix].elem_ptr =_composer->compose(ix)).get();
@@ -193,6 +178,7 @@ namespace cycfi { namespace elements
     , bool reverse
    ) const
    {
+      sync(ctx);
       auto port_bounds = get_port_bounds(ctx);
       if (!intersects(ctx.bounds, port_bounds))
          return;
@@ -272,8 +258,10 @@ namespace cycfi { namespace elements
    void list::update()
    {
       _update_request = true;
+      _requests.clear();
       _cells.clear();
       _main_axis_full_size = 0;
+      _first_changed = no_change;
    }
 
    void list::update(basic_context const& ctx) const
@@ -295,6 +283,7 @@ namespace cycfi { namespace elements
       }
       ++_layout_id;
       _update_request = false;
+      _first_changed = no_change;
    }
 
    void list::clear()
@@ -311,109 +300,138 @@ namespace cycfi { namespace elements
 
    void list::move(std::size_t pos, indices_type const& indices)
    {
-      _move_request = true;
-      if (!_request_info)
-         _request_info = std::make_unique<request_info>();
-      _request_info->_move_pos = pos;
-      _request_info->_move_indices = indices;
-}
+      _requests.push_back({request_type::move, pos, 0, indices});
+   }
 
    void list::insert(std::size_t pos, std::size_t num_items)
    {
-      _insert_request = true;
-      if (!_request_info)
-         _request_info = std::make_unique<request_info>();
-      _request_info->_insert_pos = pos;
-      _request_info->_insert_num_items = num_items;
+      _requests.push_back({request_type::insert, pos, num_items, {}});
    }
 
    void list::erase(indices_type const& indices)
    {
-      _erase_request = true;
-      if (!_request_info)
-         _request_info = std::make_unique<request_info>();
-      _request_info->_delete_indices = indices;
+      _requests.push_back({request_type::erase, 0, 0, indices});
    }
 
-   void list::move(basic_context const& ctx) const
+   void list::update(std::size_t first, std::size_t last)
    {
-      auto const& _move_indices = _request_info->_move_indices;
-      auto _move_pos = _request_info->_move_pos;
-      move_indices(_cells, _move_pos, _move_indices);
+      // Merge with the previous request if it is an update of an adjacent
+      // or overlapping range.
+      if (!_requests.empty())
+      {
+         auto& prev = _requests.back();
+         if (prev.type == request_type::update
+            && first <= prev.pos + prev.num_items && prev.pos <= last)
+         {
+            auto prev_last = prev.pos + prev.num_items;
+            prev.pos = std::min(prev.pos, first);
+            prev.num_items = std::max(prev_last, last) - prev.pos;
+            return;
+         }
+      }
+      if (first < last)
+         _requests.push_back({request_type::update, first, last - first, {}});
+   }
 
+   void list::update_positions(std::size_t from) const
+   {
+      // Recompute the cell positions starting from cell `from`. The cells
+      // before `from` are not affected.
       double y = 0;
-      auto size = _composer->size();
-      for (std::size_t i = 0; i != size; ++i)
+      if (from && from <= _cells.size())
+         y = _cells[from-1].pos + _cells[from-1].main_axis_size;
+      for (std::size_t i = from; i < _cells.size(); ++i)
       {
-         auto main_axis_size = _composer->main_axis_size(i, ctx);
          _cells[i].pos = y;
-         _cells[i].main_axis_size = main_axis_size;
-         y += main_axis_size;
+         y += _cells[i].main_axis_size;
       }
-      ++_layout_id;
-      _move_request = false;
+      _main_axis_full_size = y;
    }
 
-   void list::insert(basic_context const& ctx) const
+   // The request functions below return the index of the first cell that
+   // changed. New and updated cells are measured after all the requests are
+   // applied, when their indices are final. Until then, their size is -1.
+
+   std::size_t list::move(request_info const& r) const
    {
-      auto _insert_pos = _request_info->_insert_pos;
-      auto _insert_num_items = _request_info->_insert_num_items;
+      // The cells, along with their sizes, are moved in tandem with the
+      // items.
+      if (r.indices.empty())
+         return _cells.size();
+      auto first = move_indices(_cells, r.pos, r.indices);
+      return std::min(first, r.indices.front());
+   }
 
-      this->_composer->resize(this->_composer->size() + _insert_num_items);
-      _cells.insert(_cells.begin()+_insert_pos, _insert_num_items, cell_info{});
+   std::size_t list::insert(request_info const& r) const
+   {
+      auto pos = std::min(r.pos, _cells.size());
+      this->_composer->resize(this->_composer->size() + r.num_items);
+      _cells.insert(_cells.begin() + pos, r.num_items, cell_info{0, -1, nullptr});
+      return pos;
+   }
 
-      double y = 0;
-      auto size = _composer->size();
-      _main_axis_full_size = 0;
-      for (std::size_t i = 0; i != size; ++i)
+   std::size_t list::erase(request_info const& r) const
+   {
+      this->_composer->resize(this->_composer->size() - r.indices.size());
+      if (r.indices.empty())
+         return _cells.size();
+      erase_indices(_cells, r.indices);
+      return r.indices.front();
+   }
+
+   std::size_t list::update(request_info const& r) const
+   {
+      // The updated cells are composed again when they are visible
+      auto last = std::min(r.pos + r.num_items, _cells.size());
+      for (auto i = r.pos; i < last; ++i)
       {
-         auto main_axis_size = _composer->main_axis_size(i, ctx);
-         _cells[i].pos = y;
-         _cells[i].main_axis_size = main_axis_size;
-         y += main_axis_size;
-         _main_axis_full_size = y;
+         _cells[i].elem_ptr.reset();
+         _cells[i].layout_id = -1;
+         _cells[i].main_axis_size = -1;
       }
-
-      ++_layout_id;
-      _insert_request = false;
+      return r.pos;
    }
 
-   void list::erase(basic_context const& ctx) const
+   void list::apply_requests() const
    {
-      auto const& _delete_indices = _request_info->_delete_indices;
-      this->_composer->resize(this->_composer->size() - _delete_indices.size());
-      erase_indices(_cells, _delete_indices);
+      if (_requests.empty())
+         return;
 
-      double y = 0;
-      auto size = _composer->size();
-      _main_axis_full_size = 0;
-      for (std::size_t i = 0; i != size; ++i)
+      for (auto const& r : _requests)
       {
-         auto main_axis_size = _composer->main_axis_size(i, ctx);
-         _cells[i].pos = y;
-         _cells[i].main_axis_size = main_axis_size;
-         y += main_axis_size;
-         _main_axis_full_size = y;
+         std::size_t changed = 0;
+         switch (r.type)
+         {
+            case request_type::move:   changed = move(r); break;
+            case request_type::insert: changed = insert(r); break;
+            case request_type::erase:  changed = erase(r); break;
+            case request_type::update: changed = update(r); break;
+         }
+         _first_changed = std::min(_first_changed, changed);
       }
-
-      ++_layout_id;
-      _erase_request = false;
+      _requests.clear();
    }
 
    void list::sync(basic_context const& ctx) const
    {
       if (_update_request)
          update(ctx);
-      if (_request_info)
+
+      apply_requests();
+      if (_first_changed != no_change)
       {
-         if (_move_request)
-            move(ctx);
-         if (_insert_request)
-            insert(ctx);
-         if (_erase_request)
-            erase(ctx);
+         // Only the new and updated cells need to be measured, and only
+         // the positions from the first changed cell need to be updated.
+         auto first = std::min(_first_changed, _cells.size());
+         _first_changed = no_change;
+         for (auto i = first; i < _cells.size(); ++i)
+         {
+            if (_cells[i].main_axis_size < 0)
+               _cells[i].main_axis_size = _composer->main_axis_size(i, ctx);
+         }
+         update_positions(first);
+         ++_layout_id;
       }
-      _request_info.reset();
    }
 
    ////////////////////////////////////////////////////////////////////////////
@@ -444,6 +462,7 @@ namespace cycfi { namespace elements
 
    rect list::bounds_of(context const& ctx, std::size_t ix) const
    {
+      sync(ctx);
       rect r = ctx.bounds;
       r.top = ctx.bounds.top + _cells[ix].pos;
       r.height(_cells[ix].main_axis_size);
@@ -479,6 +498,7 @@ namespace cycfi { namespace elements
 
    rect hlist::bounds_of(context const& ctx, std::size_t ix) const
    {
+      sync(ctx);
       rect r = ctx.bounds;
       r.left = ctx.bounds.left + _cells[ix].pos;
       r.width(_cells[ix].main_axis_size);
@@ -8,6 +8,10 @@
 #include <elements/element/traversal.hpp>
 #include <elements/element/port.hpp>
 #include <elements/support/theme.hpp>
+#include <infra/utf8_utils.hpp>
+#include <algorithm>
+#include <numeric>
+#include <cctype>
 
 namespace cycfi { namespace elements
 {
@@ -176,24 +180,6 @@ namespace cycfi { namespace elements
    {
       if (k.action == key_action::press || k.action == key_action::repeat)
       {
-         auto&& equal =
-            [](auto k, auto shortcut)
-            {
-               int mask = 0xF;
-               switch (shortcut.key)
-               {
-                  case key_code::minus:
-                  case key_code::equal:
-                     mask &= ~mod_shift;
-                     break;
-                  default:
-                     break;
-               }
-               return (k.key == shortcut.key) &&
-                  ((k.modifiers & mask) == (shortcut.modifiers & mask))
-                  ;
-            };
-
          switch (k.key)
          {
             case key_code::enter:
@@ -288,38 +274,10 @@ namespace cycfi { namespace elements
             }
             break;
 
+            // The item shortcuts are registered with the view while the
+            // popup is open (see basic_popup_menu_element::open).
             default:
-            {
-               auto [c, cctx] = find_composite(ctx);
-               if (c)
-               {
-                  for (std::size_t i = 0; i != c->size(); ++i)
-                  {
-                     auto e = find_element<basic_menu_item_element*>(&c->at(i));
-                     if (e && e->is_enabled() && equal(k, e->shortcut))
-                     {
-                        if (e->on_click)
-                           e->on_click();
-                        ctx.notify(ctx, "key", e);
-
-                        // Close the popup
-                        if (auto _popup = find_parent<basic_popup_element*>(ctx))
-                           _popup->close(ctx.view);
-
-                        for (std::size_t i = 0; i != c->size(); ++i)
-                        {
-                           auto e = find_element<basic_menu_item_element*>(&c->at(i));
-                           if (e && e->is_selected())
-                           {
-                              e->select(false);
-                              break;
-                           }
-                        }
-                        return true;
-                     }
-                  }
-               }
-            }
+               break;
          }
       }
       return false;
@@ -353,4 +311,325 @@ namespace cycfi { namespace elements
    {
       return true;
    }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // menu_item_index class implementation
+   ////////////////////////////////////////////////////////////////////////////
+   namespace
+   {
+      std::string fold_case(string_view s)
+      {
+         std::string r{s};
+         for (auto& c : r)
+            c = std::tolower(static_cast<unsigned char>(c));
+         return r;
+      }
+
+      bool starts_with(std::string const& s, std::string const& prefix)
+      {
+         return s.compare(0, prefix.size(), prefix) == 0;
+      }
+   }
+
+   void menu_item_index::build(std::size_t size, get_function get)
+   {
+      _keys.clear();
+      _keys.reserve(size);
+      for (std::size_t i = 0; i != size; ++i)
+         _keys.push_back({fold_case(get(i)), i});
+
+      std::sort(_keys.begin(), _keys.end(),
+         [](key_entry const& a, key_entry const& b)
+         {
+            return (a.key < b.key) || (a.key == b.key && a.index < b.index);
+         }
+      );
+
+      _prefix.clear();
+      _first = 0;
+      _last = size;
+      _matches.resize(size);
+      std::iota(_matches.begin(), _matches.end(), 0);
+   }
+
+   bool menu_item_index::filter(string_view prefix_)
+   {
+      auto prefix = fold_case(prefix_);
+      if (prefix == _prefix)
+         return false;
+
+      if (prefix.empty())
+      {
+         _prefix.clear();
+         _first = 0;
+         _last = _keys.size();
+         _matches.resize(_keys.size());
+         std::iota(_matches.begin(), _matches.end(), 0);
+         return true;
+      }
+
+      // If the new prefix extends the previous one, the new matches are
+      // within the range matched by the previous prefix.
+      auto first = _keys.begin();
+      auto last = _keys.end();
+      if (starts_with(prefix, _prefix))
+      {
+         first += _first;
+         last = _keys.begin() + _last;
+      }
+
+      first = std::lower_bound(first, last, prefix,
+         [](key_entry const& e, std::string const& key)
+         {
+            return e.key < key;
+         }
+      );
+
+      last = std::partition_point(first, last,
+         [&prefix](key_entry const& e)
+         {
+            return starts_with(e.key, prefix);
+         }
+      );
+
+      _prefix = prefix;
+      _first = first - _keys.begin();
+      _last = last - _keys.begin();
+
+      // Present the matches in the original item order
+      _matches.clear();
+      _matches.reserve(_last - _first);
+      for (auto i = first; i != last; ++i)
+         _matches.push_back(i->index);
+      std::sort(_matches.begin(), _matches.end());
+      return true;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // list_menu_composer class implementation
+   ////////////////////////////////////////////////////////////////////////////
+   list_menu_composer::list_menu_composer(
+      std::size_t size
+    , get_function get
+    , compose_function compose
+   )
+    : _num_items(size)
+    , _compose(compose)
+   {
+      _index.build(size, get);
+      if (size)
+         _selected = 0;
+   }
+
+   std::size_t list_menu_composer::size() const
+   {
+      return _index.matches().size();
+   }
+
+   void list_menu_composer::resize(std::size_t /*s*/)
+   {
+      // The number of rows is determined by the filter
+   }
+
+   std::size_t list_menu_composer::item(std::size_t row) const
+   {
+      return _index.matches()[row];
+   }
+
+   element_ptr list_menu_composer::compose(std::size_t row)
+   {
+      using item_type =
+         proxy<indirect<shared_element<element>>, list_menu_item_element>;
+
+      auto index = item(row);
+      auto e = share(item_type{hold_any(_compose(index)), *this, row});
+      e->on_click =
+         [this, index]()
+         {
+            if (on_select)
+               on_select(index);
+         };
+      return e;
+   }
+
+   void list_menu_composer::get_limits(basic_context const& ctx) const
+   {
+      // All items share the limits of the first item
+      if (_num_items)
+      {
+         auto lim = _compose(0)->limits(ctx);
+         _secondary_axis_limits.min = lim.min.x;
+         _secondary_axis_limits.max = lim.max.x;
+         _main_axis_size = lim.min.y;
+      }
+      else
+      {
+         _secondary_axis_limits = {0, full_extent};
+         _main_axis_size = 0;
+      }
+   }
+
+   cell_composer::limits
+   list_menu_composer::secondary_axis_limits(basic_context const& ctx) const
+   {
+      if (_secondary_axis_limits.min == -1)
+         get_limits(ctx);
+      return _secondary_axis_limits;
+   }
+
+   float list_menu_composer::main_axis_size(std::size_t /*row*/, basic_context const& ctx) const
+   {
+      if (_main_axis_size == -1)
+         get_limits(ctx);
+      return _main_axis_size;
+   }
+
+   bool list_menu_composer::filter(string_view prefix)
+   {
+      if (_index.filter(prefix))
+      {
+         _selected = size()? 0 : -1;
+         return true;
+      }
+      return false;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // list_menu_item_element class implementation
+   ////////////////////////////////////////////////////////////////////////////
+   bool list_menu_item_element::key(context const& /*ctx*/, key_info /*k*/)
+   {
+      // Keys are handled by the basic_list_menu_element
+      return false;
+   }
+
+   bool list_menu_item_element::cursor(context const& ctx, point p, cursor_tracking status)
+   {
+      bool hit = ctx.bounds.includes(p);
+      if (status == cursor_tracking::leaving || (hit && !is_selected()))
+      {
+         // Unlike basic_menu_item_element, we do not have to unselect the
+         // other items. The selection is held by the composer.
+         select(hit);
+         if (auto [c, cctx] = find_composite(ctx); c)
+            cctx->view.refresh(*cctx);
+      }
+      proxy_base::cursor(ctx, p, status);
+      return hit;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // basic_list_menu_element class implementation
+   ////////////////////////////////////////////////////////////////////////////
+   view_limits basic_list_menu_element::limits(basic_context const& ctx) const
+   {
+      // Do not let the menu shrink while the items are being filtered
+      auto e_limits = subject().limits(ctx);
+      return {e_limits.min, {full_extent, full_extent}};
+   }
+
+   void basic_list_menu_element::scroll_to_selected(context const& ctx)
+   {
+      auto row = _composer->selected();
+      proxy_base::in_context_do(ctx, *_list,
+         [this, row](context const& lctx)
+         {
+            if (row >= 0 && std::size_t(row) < _list->size())
+               scrollable::find(lctx).scroll_into_view(_list->bounds_of(lctx, row));
+         }
+      );
+      ctx.view.refresh(ctx);
+   }
+
+   void basic_list_menu_element::select_next(context const& ctx, bool down)
+   {
+      auto size = int(_composer->size());
+      if (size == 0)
+         return;
+
+      auto row = _composer->selected();
+      if (row == -1)
+         row = down? 0 : size-1;
+      else
+         row = std::clamp(row + (down? 1 : -1), 0, size-1);
+
+      _composer->select(row);
+      scroll_to_selected(ctx);
+   }
+
+   void basic_list_menu_element::filter(context const& ctx, string_view prefix)
+   {
+      if (_composer->filter(prefix))
+      {
+         _list->update();
+         scroll_to_selected(ctx);
+      }
+   }
+
+   void basic_list_menu_element::close(context const& ctx)
+   {
+      ctx.notify(ctx, "key", this);
+      if (auto _popup = find_parent<basic_popup_element*>(ctx))
+         _popup->close(ctx.view);
+   }
+
+   bool basic_list_menu_element::key(context const& ctx, key_info k)
+   {
+      if (k.action == key_action::press || k.action == key_action::repeat)
+      {
+         switch (k.key)
+         {
+            case key_code::up:
+            case key_code::down:
+               select_next(ctx, k.key == key_code::down);
+               return true;
+
+            case key_code::enter:
+            {
+               auto row = _composer->selected();
+               if (row != -1 && _composer->on_select)
+                  _composer->on_select(_composer->item(row));
+               close(ctx);
+               return true;
+            }
+
+            case key_code::escape:
+               close(ctx);
+               return true;
+
+            case key_code::backspace:
+            {
+               std::string prefix{_composer->filter()};
+               if (prefix.empty())
+                  return true;
+
+               // Remove the last UTF-8 encoded code point
+               while (!prefix.empty() && (prefix.back() & 0xC0) == 0x80)
+                  prefix.pop_back();
+               if (!prefix.empty())
+                  prefix.pop_back();
+               filter(ctx, prefix);
+               return true;
+            }
+
+            default:
+               break;
+         }
+      }
+      return proxy_base::key(ctx, k);
+   }
+
+   bool basic_list_menu_element::text(context const& ctx, text_info info)
+   {
+      if (info.codepoint < 0x20 || info.codepoint == 0x7F)
+         return proxy_base::text(ctx, info);
+
+      std::string prefix{_composer->filter()};
+      if (info.text.empty())
+         prefix += codepoint_to_utf8(info.codepoint);
+      else
+         prefix += info.text;
+      filter(ctx, prefix);
+      return true;
+   }
 }}
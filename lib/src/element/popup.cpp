@@ -69,12 +69,70 @@ namespace cycfi { namespace elements
    void basic_popup_menu_element::open(view& view_)
    {
       basic_popup_element::open(view_);
+      add_shortcuts(view_);
    }
 
    void basic_popup_menu_element::close(view& view_)
    {
+      remove_shortcuts(view_);
       basic_popup_element::close(view_);
       if (_menu_button)
          _menu_button->value(0);
    }
+
+   namespace
+   {
+      template <typename F>
+      void for_each_menu_item(element& e, F&& f)
+      {
+         if (auto* item = dynamic_cast<basic_menu_item_element*>(&e))
+            f(*item);
+         else if (auto* p = dynamic_cast<proxy_base*>(&e))
+            for_each_menu_item(p->subject(), f);
+         else if (auto* i = dynamic_cast<indirect_base*>(&e))
+            for_each_menu_item(i->get(), f);
+         else if (auto* c = dynamic_cast<composite_base*>(&e))
+            for (std::size_t ix = 0; ix != c->size(); ++ix)
+               for_each_menu_item(c->at(ix), f);
+      }
+   }
+
+   void basic_popup_menu_element::add_shortcuts(view& view_)
+   {
+      remove_shortcuts(view_);
+      std::weak_ptr<element> wp = shared_from_this();
+      for_each_menu_item(subject(),
+         [&](basic_menu_item_element& item)
+         {
+            if (item.shortcut.key == key_code::unknown)
+               return;
+
+            // The item is owned by the popup, which is held weakly.
+            auto id = view_.add_shortcut(item.shortcut,
+               [wp, p = &item, &view_]()
+               {
+                  auto sp = wp.lock();
+                  if (!sp || !p->is_enabled())
+                     return false;
+                  if (p->on_click)
+                     p->on_click();
+
+                  auto& popup = static_cast<basic_popup_menu_element&>(*sp);
+                  for_each_menu_item(popup.subject(),
+                     [](basic_menu_item_element& item) { item.select(false); });
+                  popup.close(view_);
+                  return true;
+               }
+            );
+            _shortcuts.push_back(id);
+         }
+      );
+   }
+
+   void basic_popup_menu_element::remove_shortcuts(view& view_)
+   {
+      for (auto id : _shortcuts)
+         view_.remove_shortcut(id);
+      _shortcuts.clear();
+   }
 }}
@@ -117,6 +117,49 @@ namespace cycfi { namespace elements
       return {0, 0};
    }
 
+   ////////////////////////////////////////////////////////////////////////////
+   // scroll_group class implementation
+   ////////////////////////////////////////////////////////////////////////////
+   void scroll_group::track(bounds_ptr bounds)
+   {
+      _members.push_back(bounds);
+   }
+
+   void scroll_group::moved(view& view_)
+   {
+      // Coalesce: the scrollers are refreshed once, after all the scrolling
+      // done by the current event (or frame).
+      if (_pending)
+         return;
+      _pending = true;
+      view_.post([self = shared_from_this(), &view_]{ self->flush(view_); });
+   }
+
+   void scroll_group::flush(view& view_)
+   {
+      _pending = false;
+
+      rect area;
+      bool first = true;
+      for (auto i = _members.begin(); i != _members.end(); /**/)
+      {
+         if (auto bounds = i->lock())
+         {
+            area = first? *bounds : union_(area, *bounds);
+            first = false;
+            ++i;
+         }
+         else
+         {
+            // The scroller is gone
+            i = _members.erase(i);
+         }
+      }
+
+      if (!first)
+         view_.refresh(area);
+   }
+
    ////////////////////////////////////////////////////////////////////////////
    // scroller_base class implementation
    ////////////////////////////////////////////////////////////////////////////
@@ -223,7 +266,7 @@ namespace cycfi { namespace elements
          double available_height = ctx.parent->bounds.height();
 
          if (elem_height <= available_height)
-            valign(0.0);
+            port_element::valign(0.0);
          else
             ctx.bounds.top -= (elem_height - available_height) * valign();
          ctx.bounds.height(elem_height);
@@ -235,7 +278,7 @@ namespace cycfi { namespace elements
          double available_width = ctx.parent->bounds.width();
 
          if (elem_width <= available_width)
-            halign(0.0);
+            port_element::halign(0.0);
          else
             ctx.bounds.left -= (elem_width - available_width) * halign();
          ctx.bounds.width(elem_width);
@@ -269,7 +312,7 @@ namespace cycfi { namespace elements
       }
       else
       {
-         valign(0.0);
+         port_element::valign(0.0);
       }
 
       if (r.has_h)
@@ -283,7 +326,7 @@ namespace cycfi { namespace elements
       }
       else
       {
-         halign(0.0);
+         port_element::halign(0.0);
       }
       return r;
    }
@@ -292,6 +335,18 @@ namespace cycfi { namespace elements
    {
       port_element::draw(ctx);
 
+      if (_group)
+      {
+         if (!_group_bounds.ptr)
+         {
+            _group_bounds.ptr = std::make_shared<rect>();
+            _group->track(_group_bounds.ptr);
+         }
+         auto tl = ctx.canvas.user_to_device(ctx.bounds.top_left());
+         auto br = ctx.canvas.user_to_device(ctx.bounds.bottom_right());
+         *_group_bounds.ptr = {tl.x, tl.y, br.x, br.y};
+      }
+
       if (has_scrollbars())
       {
          scrollbar_bounds sb = get_scrollbar_bounds(ctx);
@@ -306,41 +361,176 @@ namespace cycfi { namespace elements
       }
    }
 
+   namespace
+   {
+      // The time constant of kinetic scrolling, in seconds. The content
+      // moves by the scroll input in a few frames, decaying exponentially.
+      constexpr double scroll_time_constant = 0.08;
+
+      // Stop scrolling when less than this is left to move (in pixels)
+      constexpr double scroll_rest_distance = 0.5;
+
+      bool can_scroll(float dir, float range, double align)
+      {
+         return range > 0 && ((dir < 0 && align < 1.0) || (dir > 0 && align > 0.0));
+      }
+   }
+
    bool scroller_base::scroll(context const& ctx, point dir, point /* p */)
    {
       view_limits e_limits = subject().limits(ctx);
-      bool redraw = false;
+      point range = {
+         e_limits.min.x - ctx.bounds.width()
+       , e_limits.min.y - ctx.bounds.height()
+      };
 
-      if (allow_hscroll())
+      bool h = allow_hscroll() && can_scroll(dir.x, range.x, halign());
+      bool v = allow_vscroll() && can_scroll(dir.y, range.y, valign());
+      if (!h && !v)
+         return false;
+
+      if (!_kinetic.ptr)
       {
-         double dx = (-dir.x / (e_limits.min.x - ctx.bounds.width()));
-         if ((dx > 0 && halign() < 1.0) || (dx < 0 && halign() > 0.0))
-         {
-            double alx = halign() + dx;
-            clamp(alx, 0.0, 1.0);
-            halign(alx);
-            redraw = true;
-         }
+         _kinetic.ptr = std::make_shared<kinetic_state>();
+         _kinetic.ptr->owner = this;
       }
 
-      if (allow_vscroll())
+      // Accumulate the input. Scroll events arriving within the same frame
+      // are coalesced into a single step.
+      auto& k = *_kinetic.ptr;
+      if (h)
+         k.pending.x += dir.x;
+      if (v)
+         k.pending.y += dir.y;
+      k.range = range;
+
+      auto tl = ctx.canvas.user_to_device(ctx.bounds.top_left());
+      auto br = ctx.canvas.user_to_device(ctx.bounds.bottom_right());
+      k.device_bounds = {tl.x, tl.y, br.x, br.y};
+
+      if (!k.running)
       {
-         double dy = (-dir.y / (e_limits.min.y - ctx.bounds.height()));
-         if ((dy > 0 && valign() < 1.0) || (dy < 0 && valign() > 0.0))
-         {
-            double aly = valign() + dy;
-            clamp(aly, 0.0, 1.0);
-            valign(aly);
-            redraw = true;
-         }
+         k.running = true;
+         ctx.view.on_frame(
+            [kp = _kinetic.ptr, &view_ = ctx.view](view::frame_duration dt)
+            {
+               if (!kp->owner)
+                  return false;
+               kp->running = kp->owner->kinetic_step(view_, *kp, dt.count());
+               return kp->running;
+            }
+         );
+      }
+      return true;
+   }
+
+   bool scroller_base::kinetic_step(view& view_, kinetic_state& k, double dt)
+   {
+      // With the exponential decay below, an input of d pixels eventually
+      // moves the content by exactly d pixels.
+      k.velocity.x += k.pending.x / scroll_time_constant;
+      k.velocity.y += k.pending.y / scroll_time_constant;
+      k.pending = {};
+
+      auto decay = std::exp(-dt / scroll_time_constant);
+      double dist_x = k.velocity.x * scroll_time_constant * (1.0 - decay);
+      double dist_y = k.velocity.y * scroll_time_constant * (1.0 - decay);
+      k.velocity.x *= decay;
+      k.velocity.y *= decay;
+
+      // Move what is left in one go when it is negligible
+      bool done =
+         std::abs(k.velocity.x * scroll_time_constant) < scroll_rest_distance &&
+         std::abs(k.velocity.y * scroll_time_constant) < scroll_rest_distance;
+      if (done)
+      {
+         dist_x += k.velocity.x * scroll_time_constant;
+         dist_y += k.velocity.y * scroll_time_constant;
+         k.velocity = {};
       }
 
-      if (redraw)
+      point moved = move_by({float(dist_x), float(dist_y)}, k.range);
+
+      // Stop at the ends
+      if (halign() == 0.0 || halign() == 1.0)
+         k.velocity.x = 0;
+      if (valign() == 0.0 || valign() == 1.0)
+         k.velocity.y = 0;
+
+      if (moved.x != 0 || moved.y != 0)
       {
          on_scroll(point(halign(), valign()));
-         ctx.view.refresh(ctx);
+         on_scroll_delta(moved);
+         scrolled(view_, k.device_bounds);
       }
-      return redraw;
+      return k.velocity.x != 0 || k.velocity.y != 0;
+   }
+
+   point scroller_base::move_by(point dist, point range)
+   {
+      // Move the content by dist (clamped to the scrollable range), and
+      // return the distance it actually moved.
+      point moved;
+      if (range.x > 0 && dist.x != 0)
+      {
+         double prev = halign();
+         double alx = prev - dist.x / range.x;
+         clamp(alx, 0.0, 1.0);
+         halign(alx);
+         moved.x = (prev - alx) * range.x;
+      }
+
+      if (range.y > 0 && dist.y != 0)
+      {
+         double prev = valign();
+         double aly = prev - dist.y / range.y;
+         clamp(aly, 0.0, 1.0);
+         valign(aly);
+         moved.y = (prev - aly) * range.y;
+      }
+      return moved;
+   }
+
+   double scroller_base::halign() const
+   {
+      return (_group && allow_hscroll())? _group->position().x : port_element::halign();
+   }
+
+   void scroller_base::halign(double val)
+   {
+      if (_group && allow_hscroll())
+         _group->position({float(val), _group->position().y});
+      else
+         port_element::halign(val);
+   }
+
+   double scroller_base::valign() const
+   {
+      return (_group && allow_vscroll())? _group->position().y : port_element::valign();
+   }
+
+   void scroller_base::valign(double val)
+   {
+      if (_group && allow_vscroll())
+         _group->position({_group->position().x, float(val)});
+      else
+         port_element::valign(val);
+   }
+
+   void scroller_base::scrolled(view& view_, rect device_bounds)
+   {
+      if (_group)
+         _group->moved(view_);
+      else
+         view_.refresh(device_bounds);
+   }
+
+   void scroller_base::scrolled(context const& ctx)
+   {
+      if (_group)
+         _group->moved(ctx.view);
+      else
+         ctx.view.refresh(ctx);
    }
 
    void scroller_base::set_position(point p)
@@ -387,7 +577,7 @@ namespace cycfi { namespace elements
          clamp(align, 0.0, 1.0);
          valign(align);
          on_scroll(point(halign(), align));
-         ctx.view.refresh(ctx);
+         scrolled(ctx);
       };
 
       auto halign_ = [&](double align)
@@ -395,7 +585,7 @@ namespace cycfi { namespace elements
          clamp(align, 0.0, 1.0);
          halign(align);
          on_scroll(point(align, valign()));
-         ctx.view.refresh(ctx);
+         scrolled(ctx);
       };
 
       if (sb.has_v)
@@ -538,7 +728,29 @@ namespace cycfi { namespace elements
                dp.x = bounds.right-r.right;
          }
 
-         return scroll(ctx, dp, ctx.cursor_pos());
+         // Move at once rather than through the kinetic scroll, so that
+         // the next call (e.g. on the next drag motion or key press) sees
+         // the new position. Pending kinetic input is cancelled.
+         if (_kinetic.ptr)
+         {
+            _kinetic.ptr->pending = {};
+            _kinetic.ptr->velocity = {};
+         }
+
+         view_limits e_limits = subject().limits(ctx);
+         point range = {
+            allow_hscroll()? e_limits.min.x - ctx.bounds.width() : 0
+          , allow_vscroll()? e_limits.min.y - ctx.bounds.height() : 0
+         };
+
+         point moved = move_by(dp, range);
+         if (moved.x != 0 || moved.y != 0)
+         {
+            on_scroll(point(halign(), valign()));
+            on_scroll_delta(moved);
+            scrolled(ctx);
+            return true;
+         }
       }
       return false;
    }
@@ -549,7 +761,7 @@ namespace cycfi { namespace elements
       {
          clamp(align, 0.0, 1.0);
          valign(align);
-         ctx.view.refresh(ctx);
+         scrolled(ctx);
       };
 
       bool handled = proxy_base::key(ctx, k);
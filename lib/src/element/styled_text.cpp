@@ -0,0 +1,305 @@
+/*=============================================================================
+   Copyright (c) 2016-2023 Joel de Guzman
+
+   Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
+=============================================================================*/
+#include <elements/element/styled_text.hpp>
+#include <elements/support/context.hpp>
+#include <elements/support/text_utils.hpp>
+#include <infra/utf8_utils.hpp>
+
+namespace cycfi::elements
+{
+   ////////////////////////////////////////////////////////////////////////////
+   // Style Runs
+   ////////////////////////////////////////////////////////////////////////////
+   namespace
+   {
+      template <typename Runs>
+      auto first_at_or_after(Runs& runs, std::size_t pos)
+      {
+         return std::lower_bound(runs.begin(), runs.end(), pos,
+            [](auto const& r, std::size_t pos_) { return r.start < pos_; });
+      }
+
+      template <typename Iter>
+      auto first_after(Iter first, Iter last, std::size_t pos)
+      {
+         return std::upper_bound(first, last, pos,
+            [](std::size_t pos_, auto const& r) { return pos_ < r.start; });
+      }
+   }
+
+   void style_runs::reset(std::size_t size, style_index style)
+   {
+      _runs = {{0, style}};
+      _size = size;
+   }
+
+   style_runs::runs_vector::const_iterator style_runs::find(std::size_t pos) const
+   {
+      // The last run that starts at or before pos. The first run always
+      // starts at 0.
+      return first_after(_runs.begin(), _runs.end(), pos) - 1;
+   }
+
+   void style_runs::apply(std::size_t first, std::size_t last, style_index style)
+   {
+      last = std::min(last, _size);
+      if (first >= last)
+         return;
+
+      // Replace the runs starting in [first, last] by a run for the new
+      // style, followed by a run that resumes the style at last.
+      auto after = style_at(last);
+      auto b = first_at_or_after(_runs, first);
+      auto i = _runs.erase(b, first_after(b, _runs.end(), last));
+      if (last < _size)
+         i = _runs.insert(i, {last, after});
+      _runs.insert(i, {first, style});
+      normalize();
+   }
+
+   void style_runs::replace(std::size_t pos, std::size_t len, std::size_t new_len)
+   {
+      erase(pos, len);
+      insert(pos, new_len);
+      normalize();
+   }
+
+   void style_runs::erase(std::size_t pos, std::size_t len)
+   {
+      if (len == 0)
+         return;
+
+      auto end = pos + len;
+      auto after = style_at(end);
+      auto b = first_at_or_after(_runs, pos);
+      auto i = _runs.erase(b, first_after(b, _runs.end(), end));
+      for (auto j = i; j != _runs.end(); ++j)
+         j->start -= len;
+      if (end < _size || _runs.empty())
+         _runs.insert(i, {pos, after});
+      _size -= len;
+   }
+
+   void style_runs::insert(std::size_t pos, std::size_t len)
+   {
+      // The inserted text takes the style of the character before it (or
+      // of the first character, if inserted at the start).
+      for (auto i = first_at_or_after(_runs, std::max<std::size_t>(pos, 1)); i != _runs.end(); ++i)
+         i->start += len;
+      _size += len;
+   }
+
+   void style_runs::normalize()
+   {
+      // Remove empty runs (keeping the last of the runs that start at the
+      // same index), then merge adjacent runs with the same style.
+      auto ri = std::unique(_runs.rbegin(), _runs.rend(),
+         [](run const& a, run const& b) { return a.start == b.start; });
+      _runs.erase(_runs.begin(), ri.base());
+
+      _runs.erase(
+         std::unique(_runs.begin(), _runs.end(),
+            [](run const& a, run const& b) { return a.style == b.style; })
+       , _runs.end()
+      );
+
+      while (_runs.size() > 1 && _runs.back().start >= _size)
+         _runs.pop_back();
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // Styled Text Box
+   ////////////////////////////////////////////////////////////////////////////
+   styled_text_box::styled_text_box(std::string_view text, font_descr font_)
+    : basic_text_box{text, font_}
+    , _styles{text_style{}}
+   {
+      _runs.reset(get_text().size());
+   }
+
+   styled_text_box::style_index styled_text_box::add_style(text_style style)
+   {
+      _styles.push_back(style);
+      return style_index(_styles.size() - 1);
+   }
+
+   void styled_text_box::set_style(style_index index, text_style style)
+   {
+      _styles[index] = style;
+   }
+
+   void styled_text_box::style(std::size_t first, std::size_t last, style_index index)
+   {
+      _runs.apply(first, last, index);
+   }
+
+   void styled_text_box::restyle()
+   {
+      _restyle_all = false;
+      restyle(0, get_text().size());
+   }
+
+   void styled_text_box::restyle(std::size_t first, std::size_t last)
+   {
+      if (!on_restyle)
+         return;
+
+      // Restyle whole lines, from the line of first, up to the line of last
+      auto _text = get_text();
+      auto prev = (first == 0)? _text.npos : _text.rfind(U'\n', first - 1);
+      auto line = (prev == _text.npos)? 0 : prev + 1;
+      while (true)
+      {
+         auto end = _text.find(U'\n', line);
+         if (end == _text.npos)
+            end = _text.size();
+
+         _runs.apply(line, end, 0);
+         on_restyle(*this, line, _text.substr(line, end - line));
+
+         if (end >= last || end == _text.size())
+            break;
+         line = end + 1;
+      }
+   }
+
+   void styled_text_box::edit_text(std::u32string_view text, text_edit const& edit)
+   {
+      if (!edit.empty())
+         _runs.replace(edit.pos, edit.old_len, edit.new_len);
+
+      basic_text_box::edit_text(text, edit);
+
+      if (!edit.empty() && !_restyle_all)
+         restyle(edit.pos, edit.pos + edit.new_len);
+   }
+
+   void styled_text_box::for_each_piece(
+      context const& ctx
+    , std::size_t first
+    , std::size_t last
+    , piece_function f
+   )
+   {
+      auto _text = get_text();
+      auto const& layout = get_layout();
+      auto m = get_font().metrics();
+      auto x = ctx.bounds.left;
+      auto y = ctx.bounds.top + m.ascent;
+
+      while (first < last)
+      {
+         // A piece ends at the end of the line of its first character. Find
+         // the first character on a lower line by bisection.
+         auto line_y = layout.caret_point(first).y;
+         auto lo = first + 1;
+         auto hi = last;
+         while (lo < hi)
+         {
+            auto mid = lo + (hi - lo) / 2;
+            if (layout.caret_point(mid).y > line_y)
+               hi = mid;
+            else
+               lo = mid + 1;
+         }
+
+         // Line breaks are not drawn
+         auto end = lo;
+         while (end > first && (_text[end-1] == U'\n' || _text[end-1] == U'\r'))
+            --end;
+
+         if (end > first)
+         {
+            auto p = layout.caret_point(first);
+            f(first, end, point{x + p.x, y + p.y});
+         }
+         first = lo;
+      }
+   }
+
+   void styled_text_box::draw(context const& ctx)
+   {
+      if (_restyle_all && on_restyle)
+         restyle();
+
+      // Draw the backgrounds of the visible runs below the selection and
+      // the text.
+      std::size_t first, last;
+      visible_range(ctx, first, last);
+      {
+         auto& cnv = ctx.canvas;
+         auto  state = cnv.new_state();
+         auto  _text = get_text();
+         auto  m = get_font().metrics();
+         cnv.font(get_font());
+
+         _runs.for_each(first, last,
+            [&](std::size_t a, std::size_t b, style_index s)
+            {
+               auto const& style = _styles[s];
+               if (style.background.alpha == 0)
+                  return;
+
+               cnv.fill_style(style.background);
+               for_each_piece(ctx, a, b,
+                  [&](std::size_t pa, std::size_t pb, point p)
+                  {
+                     auto width = cnv.measure_text(to_utf8(_text.substr(pa, pb - pa))).size.x;
+                     cnv.fill_rect({p.x, p.y - (m.leading + m.ascent), p.x + width, p.y + m.descent});
+                  }
+               );
+            }
+         );
+      }
+
+      basic_text_box::draw(ctx);
+   }
+
+   void styled_text_box::draw_text(context const& ctx)
+   {
+      auto& cnv = ctx.canvas;
+      auto  state = cnv.new_state();
+      auto  _text = get_text();
+      auto  m = get_font().metrics();
+      auto  opacity = is_enabled()? 1.0f : float(get_theme().disabled_opacity);
+      auto  bold_width = (m.ascent + m.descent) / 30;
+
+      cnv.add_rect(ctx.bounds);
+      cnv.clip();
+      cnv.font(get_font());
+      cnv.text_align(cnv.left | cnv.baseline);
+
+      std::size_t first, last;
+      visible_range(ctx, first, last);
+
+      // One glyph run for each style run, in each visible line
+      _runs.for_each(first, last,
+         [&](std::size_t a, std::size_t b, style_index s)
+         {
+            auto const& style = _styles[s];
+            auto c = (s == 0)? get_color() : style.text_color;
+            c = c.opacity(c.alpha * opacity);
+
+            cnv.fill_style(c);
+            if (style.bold)
+            {
+               cnv.stroke_style(c);
+               cnv.line_width(bold_width);
+            }
+
+            for_each_piece(ctx, a, b,
+               [&](std::size_t pa, std::size_t pb, point p)
+               {
+                  auto utf8 = to_utf8(_text.substr(pa, pb - pa));
+                  cnv.fill_text(utf8, p);
+                  if (style.bold)
+                     cnv.stroke_text(utf8, p);
+               }
+            );
+         }
+      );
+   }
+}
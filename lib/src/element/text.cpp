@@ -8,9 +8,17 @@
 #include <elements/support/theme.hpp>
 #include <elements/support/context.hpp>
 #include <elements/view.hpp>
+#include <elements/support/text_utils.hpp>
 #include <infra/utf8_utils.hpp>
+#include <algorithm>
+#include <iterator>
+#include <chrono>
 #include <utility>
 
+#if defined(_MSC_VER)
+# include <intrin.h>
+#endif
+
 namespace cycfi { namespace elements
 {
    using namespace std::chrono_literals;
@@ -80,8 +88,7 @@ namespace cycfi { namespace elements
 
    void static_text_box::set_text(std::u32string_view text)
    {
-      _layout.text(text);
-      _layout.flow(_current_size.x);
+      edit_text(text, {0, get_text().size(), text.size()});
    }
 
    void static_text_box::set_text(std::string_view text_)
@@ -100,7 +107,7 @@ namespace cycfi { namespace elements
       auto utf32 = to_utf32(text);
       auto size = utf32.size();
       s.insert(pos, std::move(utf32));
-      set_text(s);
+      edit_text(s, {pos, 0, size});
       return size;
    }
 
@@ -109,16 +116,24 @@ namespace cycfi { namespace elements
       std::u32string s{get_text().data(), get_text().size()};
       auto utf32 = to_utf32(text);
       auto size = utf32.size();
+      len = std::min(len, s.size() - std::min(pos, s.size()));
       s.replace(pos, len, std::move(utf32));
-      set_text(s);
+      edit_text(s, {pos, len, size});
       return size;
    }
 
    void static_text_box::erase(std::size_t pos, std::size_t len)
    {
       std::u32string s{get_text().data(), get_text().size()};
+      len = std::min(len, s.size() - std::min(pos, s.size()));
       s.erase(pos, len);
-      set_text(s);
+      edit_text(s, {pos, len, 0});
+   }
+
+   void static_text_box::edit_text(std::u32string_view text, text_edit const& /* edit */)
+   {
+      _layout.text(text);
+      _layout.flow(_current_size.x);
    }
 
    ////////////////////////////////////////////////////////////////////////////
@@ -176,7 +191,14 @@ namespace cycfi { namespace elements
          _scroll_into_view = false;
       }
 
+      draw_matches(ctx);
       draw_selection(ctx);
+      draw_text(ctx);
+      draw_caret(ctx);
+   }
+
+   void basic_text_box::draw_text(context const& ctx)
+   {
       if (_enabled)
       {
          static_text_box::draw(ctx);
@@ -188,7 +210,21 @@ namespace cycfi { namespace elements
          static_text_box::draw(ctx);
          set_color(c);
       }
-      draw_caret(ctx);
+   }
+
+   void basic_text_box::visible_range(context const& ctx, std::size_t& first, std::size_t& last)
+   {
+      auto _text = get_text();
+      auto visible = get_port_bounds(ctx);
+      clamp(visible.left, ctx.bounds.left, ctx.bounds.right);
+      clamp(visible.right, ctx.bounds.left, ctx.bounds.right);
+      clamp(visible.top, ctx.bounds.top, ctx.bounds.bottom);
+      clamp(visible.bottom, ctx.bounds.top, ctx.bounds.bottom);
+
+      auto first_pos = caret_position(ctx, visible.top_left());
+      auto last_pos = caret_position(ctx, visible.bottom_right());
+      first = first_pos? first_pos - _text.data() : 0;
+      last = last_pos? last_pos - _text.data() : _text.size();
    }
 
    bool basic_text_box::click(context const& ctx, mouse_button btn)
@@ -210,7 +246,6 @@ namespace cycfi { namespace elements
       }
 
       char32_t const* begin = _text.data();
-      int _size = _text.size();
 
       if (char32_t const* pos = caret_position(ctx, btn.pos))
       {
@@ -227,20 +262,11 @@ namespace cycfi { namespace elements
                _select_end = end;
             };
 
-            if (btn.num_clicks == 2)
+            if (btn.num_clicks == 2 || btn.num_clicks == 3)
             {
-               while (end < _size && !word_break(end))
-                  ++end;
-               while (start >= 0 && !word_break(start))
-                  --start;
-               fixup();
-            }
-            else if (btn.num_clicks == 3)
-            {
-               while (end < _size && !line_break(end))
-                  end++;
-               while (start >= 0 && !line_break(start))
-                  start--;
+               bool line = btn.num_clicks == 3;
+               end = int(find_break(end, line, true, true));
+               start = int(find_break(start, line, true, false));
                fixup();
             }
          }
@@ -289,7 +315,7 @@ namespace cycfi { namespace elements
    namespace
    {
       void add_undo(
-         context const& ctx
+         view& view_
        , std::function<void()>& typing_state
        , std::function<void()> undo_f
        , std::function<void()> redo_f
@@ -297,10 +323,20 @@ namespace cycfi { namespace elements
       {
          if (typing_state)
          {
-            ctx.view.add_undo({typing_state, undo_f});
+            view_.add_undo({typing_state, undo_f});
             typing_state = {}; // reset
          }
-         ctx.view.add_undo({undo_f, redo_f});
+         view_.add_undo({undo_f, redo_f});
+      }
+
+      void add_undo(
+         context const& ctx
+       , std::function<void()>& typing_state
+       , std::function<void()> undo_f
+       , std::function<void()> redo_f
+      )
+      {
+         add_undo(ctx.view, typing_state, undo_f, redo_f);
       }
    }
 
@@ -317,7 +353,11 @@ namespace cycfi { namespace elements
       if (_select_start > _select_end)
          std::swap(_select_end, _select_start);
 
-      std::string text = codepoint_to_utf8(info_.codepoint);
+      // Insert the whole text at once, however long
+      std::string text = info_.text.empty()?
+         codepoint_to_utf8(info_.codepoint) : std::string{info_.text};
+      int num_chars = std::count_if(text.begin(), text.end(),
+         [](char c) { return (c & 0xC0) != 0x80; });
 
       if (!_typing_state)
          _typing_state = capture_state();
@@ -339,11 +379,11 @@ namespace cycfi { namespace elements
       {
          _select_end = _select_start;
          scroll_into_view(ctx, true);
-         _select_end = _select_start += 1;
+         _select_end = _select_start += num_chars;
       }
       else
       {
-         _select_end = _select_start += 1;
+         _select_end = _select_start += num_chars;
          scroll_into_view(ctx, true);
       }
       return true;
@@ -351,9 +391,20 @@ namespace cycfi { namespace elements
 
    void basic_text_box::set_text(std::u32string_view text_)
    {
-      static_text_box::set_text(text_);
+      edit_text(text_, find_edit(get_text(), text_));
+   }
+
+   void basic_text_box::edit_text(std::u32string_view text_, text_edit const& edit)
+   {
+      static_text_box::edit_text(text_, edit);
+      if (!edit.empty())
+         update_caret_map(edit.pos, edit.old_len, edit.new_len);
       _select_start = std::min<int>(_select_start, text_.size());
       _select_end = std::min<int>(_select_end, text_.size());
+
+      // Update the matches around the edit
+      if (!_find_pattern.empty() && !edit.empty())
+         update_matches(edit);
    }
 
    bool basic_text_box::key(context const& ctx, key_info k)
@@ -407,13 +458,8 @@ namespace cycfi { namespace elements
       {
          if (_select_end < static_cast<int>(_text.size()))
          {
-            int pos = _select_end;
-            int size = _text.size();
-            while (pos != size && word_break(pos))
-               ++pos;
-            while (pos != size && !word_break(pos))
-               ++pos;
-            _select_end = pos;
+            auto pos = find_break(_select_end, false, false, true);
+            _select_end = int(find_break(pos, false, true, true));
          }
       };
 
@@ -421,14 +467,11 @@ namespace cycfi { namespace elements
       {
          if (_select_end > 0)
          {
-            int pos = _select_end-1;
-            while (pos != 0 && word_break(pos))
-               --pos;
-            while (pos != 0 && !word_break(pos))
-               --pos;
+            auto pos = find_break(_select_end-1, false, false, false);
+            pos = find_break(pos, false, true, false);
             if (pos != 0)
                ++pos;
-            _select_end = pos;
+            _select_end = int(pos);
          }
       };
 
@@ -532,9 +575,9 @@ namespace cycfi { namespace elements
             case key_code::v:
                if (editable() && (k.modifiers & mod_action))
                {
+                  // The undo is added when the pasted text arrives
                   paste(ctx.view, start, end);
                   save_x = true;
-                  add_undo(ctx, _typing_state, undo_f, capture_state());
                   handled = true;
                }
                break;
@@ -660,30 +703,16 @@ namespace cycfi { namespace elements
       }
    }
 
-   void basic_text_box::draw_selection(context const& ctx)
+   namespace
    {
-      if (_select_start == -1)
-         return;
-
-      auto& canvas = ctx.canvas;
-      auto const& theme = get_theme();
-      auto _text = get_text();
-
-      if (!_text.empty())
+      // Fill the text from the caret r1 to the caret r2, which may span
+      // multiple lines.
+      void fill_text_range(canvas& canvas, rect const& bounds, rect r1, rect r2)
       {
-         auto  start_info = caret_info(ctx, _text.data() + _select_start);
-         rect& r1 = start_info.caret;
-         r1.right = ctx.bounds.right;
-
-         auto  end_info = caret_info(ctx, _text.data() + _select_end);
-         rect& r2 = end_info.caret;
+         r1.right = bounds.right;
          r2.right = r2.left;
-         r2.left = ctx.bounds.left;
+         r2.left = bounds.left;
 
-         auto color = theme.text_box_hilite_color;
-         if (!_is_focus)
-            color = color.opacity(0.15);
-         canvas.fill_style(color);
          if (r1.top == r2.top)
          {
             canvas.fill_rect({r1.left, r1.top, r2.right, r1.bottom});
@@ -705,16 +734,104 @@ namespace cycfi { namespace elements
       }
    }
 
+   void basic_text_box::draw_selection(context const& ctx)
+   {
+      if (_select_start == -1)
+         return;
+
+      auto& canvas = ctx.canvas;
+      auto const& theme = get_theme();
+      auto _text = get_text();
+
+      if (!_text.empty())
+      {
+         auto  start_info = caret_info(ctx, _text.data() + _select_start);
+         auto  end_info = caret_info(ctx, _text.data() + _select_end);
+
+         auto color = theme.text_box_hilite_color;
+         if (!_is_focus)
+            color = color.opacity(0.15);
+         canvas.fill_style(color);
+         fill_text_range(canvas, ctx.bounds, start_info.caret, end_info.caret);
+      }
+   }
+
+   void basic_text_box::draw_matches(context const& ctx)
+   {
+      auto _text = get_text();
+      auto len = _find_pattern.size();
+      if (_matches.empty() || _text.empty())
+         return;
+
+      // Only the matches in the visible part of the text are drawn
+      std::size_t first, last;
+      visible_range(ctx, first, last);
+
+      auto& canvas = ctx.canvas;
+      canvas.fill_style(get_theme().text_box_match_color);
+
+      auto i = std::lower_bound(_matches.begin(), _matches.end(), (first > len)? first - len : 0);
+      for (; i != _matches.end() && *i <= last; ++i)
+      {
+         if (*i + len > _text.size())
+            break;
+         auto  start_info = caret_info(ctx, _text.data() + *i);
+         auto  end_info = caret_info(ctx, _text.data() + *i + len);
+         fill_text_range(canvas, ctx.bounds, start_info.caret, end_info.caret);
+      }
+   }
+
    char32_t const* basic_text_box::caret_position(context const& ctx, point p)
    {
       auto  m = get_font().metrics();
       auto  x = ctx.bounds.left;
       auto  y = ctx.bounds.top + m.ascent;
 
-      auto  index = get_layout().caret_index(p.x-x, p.y-y); // relative to top-left
-      if (index != get_layout().npos)
-         return get_text().data() + index;
-      return nullptr;
+      auto  rx = p.x-x;                      // relative to top-left
+      auto  ry = p.y-y;
+
+      // Find the line, then the row, by bisection. Points above the first
+      // row or below the last row are left to the text layout.
+      sync_caret_map();
+      auto  num_lines = _caret_lines.size();
+      auto  lo = std::size_t{0};
+      auto  hi = num_lines;
+      while (lo < hi)
+      {
+         auto mid = lo + (hi - lo) / 2;
+         if (caret_line_y(mid) - m.ascent > ry)
+            hi = mid;
+         else
+            lo = mid + 1;
+      }
+
+      auto  last_y = caret_line_y(num_lines-1);
+      if (lo == 0 || ry > last_y + get_caret_line(num_lines-1).rows.back().y + m.descent + m.leading)
+      {
+         auto  index = get_layout().caret_index(rx, ry);
+         if (index != get_layout().npos)
+            return get_text().data() + index;
+         return nullptr;
+      }
+
+      auto& line = get_caret_line(lo-1);
+      auto  row = std::upper_bound(line.rows.begin(), line.rows.end(), ry - line.y,
+                     [&](float y_, caret_row const& r) { return y_ < r.y - m.ascent; }
+                  );
+      if (row != line.rows.begin())
+         --row;
+
+      // The caret positions in the row: up to the first character of the
+      // next row, or the last caret position of the line.
+      auto  first = row->first;
+      auto  last = (row + 1 != line.rows.end())? (row + 1)->first - 1 : line.x.size() - 1;
+      if (last < first)
+         last = first;
+
+      auto  i = std::upper_bound(line.x.begin() + first, line.x.begin() + last + 1, rx) - line.x.begin();
+      if (i > std::ptrdiff_t(first) && (std::size_t(i) > last || rx - line.x[i-1] <= line.x[i] - rx))
+         --i;
+      return get_text().data() + line.first + i;
    }
 
    basic_text_box::caret_metrics basic_text_box::caret_info(context const& ctx, char32_t const* s)
@@ -756,13 +873,27 @@ namespace cycfi { namespace elements
       }
    }
 
+   namespace
+   {
+      // The clipboard text is converted to UTF-8 only when it is pasted
+      payload_data clipboard_text(std::u32string_view text)
+      {
+         return payload_data{
+            [text = std::u32string(text)]()
+            {
+               return payload_buffer{to_utf8(text)};
+            }
+         };
+      }
+   }
+
    void basic_text_box::cut(view& /* v */, int start, int end)
    {
       if (start != -1 && start != end)
       {
          auto  end_ = std::max(start, end);
          auto  start_ = std::min(start, end);
-         clipboard(to_utf8(get_text().substr(start, end_-start_)));
+         provide_clipboard(clipboard_text(get_text().substr(start_, end_-start_)));
          delete_(false);
       }
    }
@@ -773,22 +904,62 @@ namespace cycfi { namespace elements
       {
          auto  end_ = std::max(start, end);
          auto  start_ = std::min(start, end);
-         clipboard(to_utf8(get_text().substr(start, end_-start_)));
+         provide_clipboard(clipboard_text(get_text().substr(start_, end_-start_)));
       }
    }
 
-   void basic_text_box::paste(view& /* v */, int start, int end)
+   void basic_text_box::paste(view& v, int start, int end)
    {
       if (start != -1)
       {
-         auto  end_ = std::max(start, end);
-         auto  start_ = std::min(start, end);
-         std::string ins = clipboard();
-         start += replace(start, end_-start_, ins);
-         _select_end = _select_start = start;
+         request_paste(v,
+            [this, start, end](std::u32string_view ins)
+            {
+               auto  size = int(get_text().size());
+               auto  end_ = std::min(std::max(start, end), size);
+               auto  start_ = std::min(std::min(start, end), end_);
+
+               std::u32string text{get_text()};
+               text.replace(start_, end_-start_, ins);
+               edit_text(text, {std::size_t(start_), std::size_t(end_-start_), ins.size()});
+               _select_end = _select_start = start_ + int(ins.size());
+            }
+         );
       }
    }
 
+   void basic_text_box::request_paste(view& v, paste_function f)
+   {
+      if (_paste.ptr)
+         _paste.ptr->owner = nullptr;
+
+      auto state = std::make_shared<paste_state>();
+      state->owner = this;
+      state->view_ = &v;
+      state->f = std::move(f);
+      _paste.ptr = state;
+
+      request_clipboard(
+         [state](std::string_view text)
+         {
+            if (!state->owner)
+               return;
+
+            auto& self = *state->owner;
+            self._paste.ptr.reset();
+            state->owner = nullptr;
+
+            // The undo state is captured when the paste is applied, so
+            // that undo does not revert what was typed in the meantime.
+            auto undo_f = self.capture_state();
+            state->f(to_utf32(text));
+            add_undo(*state->view_, self._typing_state, undo_f, self.capture_state());
+            self.scroll_into_view();
+            state->view_->refresh(self);
+         }
+      );
+   }
+
    std::function<void()>
    basic_text_box::capture_state()
    {
@@ -918,6 +1089,504 @@ namespace cycfi { namespace elements
       return index == 0 || get_layout().line_break(index) == text_layout::must_break;
    }
 
+   namespace
+   {
+      // Calls f(first, size) for each hard line in text[first, last), each
+      // ending with a '\n', except the last line of the text.
+      template <typename F>
+      void split_lines(std::u32string_view text, std::size_t first, std::size_t last, F&& f)
+      {
+         while (true)
+         {
+            auto nl = text.find(U'\n', first);
+            if (nl == text.npos || nl >= last)
+            {
+               if (first < last || last == text.size())
+                  f(first, last - first);
+               break;
+            }
+            f(first, nl + 1 - first);
+            first = nl + 1;
+         }
+      }
+
+      template <typename Lines>
+      std::size_t line_index(Lines const& lines, std::size_t index)
+      {
+         auto i = std::upper_bound(lines.begin(), lines.end(), index,
+            [](std::size_t index_, auto const& line) { return index_ < line.first; });
+         return (i - lines.begin()) - 1;
+      }
+
+      inline int lowest_bit(std::uint64_t w)
+      {
+#if defined(_MSC_VER)
+         unsigned long i;
+         _BitScanForward64(&i, w);
+         return int(i);
+#else
+         return __builtin_ctzll(w);
+#endif
+      }
+
+      inline int highest_bit(std::uint64_t w)
+      {
+#if defined(_MSC_VER)
+         unsigned long i;
+         _BitScanReverse64(&i, w);
+         return int(i);
+#else
+         return 63 - __builtin_clzll(w);
+#endif
+      }
+   }
+
+   void basic_text_box::set_font(font_descr f)
+   {
+      static_text_box::set_font(f);
+
+      // The caret offsets depend on the font. Rebuild the map when next
+      // needed.
+      _caret_lines.clear();
+   }
+
+   void basic_text_box::sync_caret_map()
+   {
+      auto _text = get_text();
+      auto width = current_size().x;
+      bool in_sync = !_caret_lines.empty() &&
+         _caret_lines.back().first + _caret_lines.back().size == _text.size();
+
+      if (!in_sync)
+      {
+         _caret_lines.clear();
+         split_lines(_text, 0, _text.size(),
+            [this](std::size_t first, std::size_t size)
+            {
+               auto& line = _caret_lines.emplace_back();
+               line.first = first;
+               line.size = size;
+            }
+         );
+      }
+      else if (width != _caret_map_width)
+      {
+         for (auto& line : _caret_lines)
+            line.built = line.y_valid = false;
+      }
+      _caret_map_width = width;
+   }
+
+   void basic_text_box::update_caret_map(std::size_t pos, std::size_t old_len, std::size_t new_len)
+   {
+      // The map is built when first needed
+      if (_caret_lines.empty())
+         return;
+
+      // Replace the lines touched by the edit by the new lines in their
+      // place. The lines past them are only shifted.
+      auto i0 = line_index(_caret_lines, pos);
+      auto i1 = line_index(_caret_lines, pos + old_len);
+      auto first = _caret_lines[i0].first;
+      auto last = _caret_lines[i1].first + _caret_lines[i1].size + new_len - old_len;
+
+      for (auto i = i1 + 1; i < _caret_lines.size(); ++i)
+      {
+         auto& line = _caret_lines[i];
+         line.first = line.first + new_len - old_len;
+         line.y_valid = false;
+      }
+
+      caret_lines lines;
+      split_lines(get_text(), first, last,
+         [&lines](std::size_t first_, std::size_t size)
+         {
+            auto& line = lines.emplace_back();
+            line.first = first_;
+            line.size = size;
+         }
+      );
+
+      auto i = _caret_lines.erase(_caret_lines.begin() + i0, _caret_lines.begin() + i1 + 1);
+      _caret_lines.insert(i, std::make_move_iterator(lines.begin()), std::make_move_iterator(lines.end()));
+   }
+
+   basic_text_box::caret_line& basic_text_box::get_caret_line(std::size_t index)
+   {
+      auto& line = _caret_lines[index];
+      if (line.built)
+         return line;
+
+      auto const& layout = get_layout();
+      auto _text = get_text();
+      auto y = caret_line_y(index);
+      bool last_line = line.first + line.size == _text.size();
+
+      // The caret positions are the characters of the line, and, for the
+      // last line, the end of the text.
+      auto num_carets = last_line? line.size + 1 : line.size;
+      auto num_words = (line.size + 63) / 64;
+
+      line.x.resize(num_carets);
+      line.rows.clear();
+      line.word_breaks.assign(num_words, 0);
+      line.line_breaks.assign(num_words, 0);
+
+      for (std::size_t i = 0; i != num_carets; ++i)
+      {
+         auto p = layout.caret_point(line.first + i);
+         line.x[i] = p.x;
+         if (line.rows.empty() || p.y - y > line.rows.back().y)
+            line.rows.push_back({i, p.y - y});
+
+         if (i != line.size)
+         {
+            auto bit = std::uint64_t(1) << (i % 64);
+            if (word_break(int(line.first + i)))
+               line.word_breaks[i / 64] |= bit;
+            if (line_break(int(line.first + i)))
+               line.line_breaks[i / 64] |= bit;
+         }
+      }
+
+      line.built = true;
+      return line;
+   }
+
+   std::size_t basic_text_box::caret_line_of(std::size_t index)
+   {
+      sync_caret_map();
+      return line_index(_caret_lines, index);
+   }
+
+   float basic_text_box::caret_line_y(std::size_t index)
+   {
+      auto& line = _caret_lines[index];
+      if (!line.y_valid)
+      {
+         line.y = get_layout().caret_point(line.first).y;
+         line.y_valid = true;
+      }
+      return line.y;
+   }
+
+   std::size_t basic_text_box::find_break(std::size_t pos, bool line_, bool value, bool forward)
+   {
+      // Forward: the first index, from pos, where the break is value, or
+      // the end of the text. Backward: the last index, up to pos, where
+      // the break is value, or 0.
+      auto size = get_text().size();
+      if (forward && pos >= size)
+         return size;
+      if (!forward && pos == 0)
+         return 0;
+
+      auto n = caret_line_of(std::min(pos, size-1));
+      while (true)
+      {
+         auto& line = get_caret_line(n);
+         auto const& bits = line_? line.line_breaks : line.word_breaks;
+         if (line.size != 0)
+         {
+            auto i = std::min(pos, line.first + line.size - 1) - line.first;
+            auto k = i / 64;
+            auto w = value? bits[k] : ~bits[k];
+            if (forward)
+            {
+               w &= ~std::uint64_t(0) << (i % 64);
+               while (w == 0 && ++k != bits.size())
+                  w = value? bits[k] : ~bits[k];
+               if (w != 0)
+               {
+                  auto found = line.first + k * 64 + lowest_bit(w);
+                  if (found < line.first + line.size)
+                     return found;
+               }
+            }
+            else
+            {
+               w &= ~std::uint64_t(0) >> (63 - i % 64);
+               while (w == 0 && k-- != 0)
+                  w = value? bits[k] : ~bits[k];
+               if (w != 0)
+                  return line.first + k * 64 + highest_bit(w);
+            }
+         }
+
+         if (forward)
+         {
+            if (++n == _caret_lines.size())
+               return size;
+            pos = _caret_lines[n].first;
+         }
+         else
+         {
+            if (n-- == 0)
+               return 0;
+            pos = _caret_lines[n].first + _caret_lines[n].size;
+         }
+      }
+   }
+
+   namespace
+   {
+      // The time find_all may take in each frame
+      constexpr auto find_time_budget = 4ms;
+
+      // find_all searches this many characters at a time between checks
+      // of the time budget
+      constexpr std::size_t find_chunk_size = 1 << 16;
+   }
+
+   bool basic_text_box::find_next(std::u32string_view pattern)
+   {
+      auto _text = get_text();
+      if (pattern.empty() || pattern.size() > _text.size())
+         return false;
+
+      std::size_t from = (_select_start == -1)? 0 : std::max(_select_start, _select_end);
+      auto i = _text.find(pattern, from);
+      if (i == _text.npos)
+         i = _text.find(pattern);      // wrap around
+      if (i == _text.npos)
+         return false;
+
+      _select_start = int(i);
+      _select_end = int(i + pattern.size());
+      _scroll_into_view = true;
+      return true;
+   }
+
+   bool basic_text_box::find_previous(std::u32string_view pattern)
+   {
+      auto _text = get_text();
+      if (pattern.empty() || pattern.size() > _text.size())
+         return false;
+
+      auto i = _text.npos;
+      int from = std::min(_select_start, _select_end);
+      if (from > 0)
+         i = _text.rfind(pattern, from - 1);
+      if (i == _text.npos)
+         i = _text.rfind(pattern);     // wrap around
+      if (i == _text.npos)
+         return false;
+
+      _select_start = int(i);
+      _select_end = int(i + pattern.size());
+      _scroll_into_view = true;
+      return true;
+   }
+
+   void basic_text_box::find_all(view& view_, std::u32string_view pattern)
+   {
+      _find_pattern = pattern;
+      if (!_find.ptr)
+      {
+         _find.ptr = std::make_shared<find_state>();
+         _find.ptr->owner = this;
+      }
+      _find.ptr->view_ = &view_;
+      start_find_all();
+   }
+
+   void basic_text_box::clear_matches()
+   {
+      _find_pattern.clear();
+      _matches.clear();
+   }
+
+   void basic_text_box::start_find_all()
+   {
+      _matches.clear();
+      if (!_find.ptr || !_find.ptr->view_ || _find_pattern.empty())
+         return;
+
+      auto& f = *_find.ptr;
+      f.pos = 0;
+      if (!f.running)
+      {
+         f.running = true;
+         f.view_->on_frame(
+            [fp = _find.ptr](view::frame_duration)
+            {
+               if (!fp->owner)
+                  return false;
+               fp->running = fp->owner->find_step(*fp);
+               return fp->running;
+            }
+         );
+      }
+   }
+
+   void basic_text_box::update_matches(text_edit const& edit)
+   {
+      if (!_find.ptr || !_find.ptr->view_)
+         return;
+
+      auto& f = *_find.ptr;
+      auto _text = get_text();
+      auto const& pattern = _find_pattern;
+      auto const len = pattern.size();
+      auto const old_end = edit.pos + edit.old_len;
+      auto const new_end = edit.pos + edit.new_len;
+      auto const start = (edit.pos >= len)? edit.pos - len + 1 : 0;
+
+      // While the background search is running, the matches at f.pos and
+      // beyond are not found yet. If the edit is past the found matches,
+      // there is nothing to update. Otherwise, limit is where the search
+      // resumes in the new text.
+      auto limit = _text.size();
+      if (f.running)
+      {
+         if (edit.pos >= f.pos + len - 1)
+            return;
+         limit = (f.pos >= old_end)? f.pos - edit.old_len + edit.new_len : new_end;
+      }
+
+      // Keep the matches before the edit, drop those that overlap it, and
+      // shift those after it.
+      auto first = std::lower_bound(_matches.begin(), _matches.end(), start);
+      auto last = std::lower_bound(first, _matches.end(), old_end);
+      matches_vector after;
+      after.reserve(_matches.end() - last);
+      for (auto i = last; i != _matches.end(); ++i)
+         after.push_back(*i - edit.old_len + edit.new_len);
+
+      // Matches do not overlap: the dropped and displaced old matches may
+      // have hidden other occurrences, starting before their end.
+      std::size_t hidden_end = 0;
+      if (last != first && *(last-1) + len > old_end)
+         hidden_end = *(last-1) + 2*len - 1 - edit.old_len + edit.new_len;
+
+      auto from = (first == _matches.begin())? start : std::max(start, *(first-1) + len);
+      _matches.erase(first, _matches.end());
+
+      // Search from the edit until a match falls on one of the old matches
+      // after it. A new match may displace old ones.
+      auto q = after.begin();
+      auto window_end = std::min(limit, new_end + len - 1);
+      bool in_step = false;
+      while (true)
+      {
+         for (; q != after.end() && *q < from; ++q)
+            hidden_end = *q + 2*len - 1;
+
+         auto bound = std::max(window_end, hidden_end);
+         if (q != after.end())
+            bound = std::max(bound, *q + len);
+         bound = std::min(bound, limit);
+
+         auto i = _text.substr(0, bound).find(pattern, from);
+         if (i == _text.npos)
+            break;
+         if (q != after.end() && *q == i)
+         {
+            in_step = true;
+            break;
+         }
+         _matches.push_back(i);
+         from = i + len;
+      }
+
+      if (in_step)
+         _matches.insert(_matches.end(), q, after.end());
+      if (f.running)
+         f.pos = in_step? limit : std::max(from, (limit >= len)? limit - len + 1 : 0);
+
+      if (on_find_all)
+         on_find_all(_matches.size(), !f.running);
+   }
+
+   bool basic_text_box::find_step(find_state& f)
+   {
+      auto _text = get_text();
+      auto const& pattern = _find_pattern;
+      if (pattern.empty())
+         return false;
+
+      auto deadline = std::chrono::steady_clock::now() + find_time_budget;
+      auto num_found = _matches.size();
+      bool done = false;
+
+      while (!done)
+      {
+         // Search the next chunk. The chunk overlaps the next one by the
+         // length of the pattern, less one, for matches that straddle both.
+         auto last = std::min(_text.size(), f.pos + find_chunk_size + pattern.size() - 1);
+         auto chunk = _text.substr(0, last);
+         for (auto i = chunk.find(pattern, f.pos); i != chunk.npos; i = chunk.find(pattern, f.pos))
+         {
+            _matches.push_back(i);
+            f.pos = i + pattern.size();
+         }
+         if (last + 1 >= pattern.size())
+            f.pos = std::max(f.pos, last + 1 - pattern.size());
+
+         if (last == _text.size())
+            done = true;
+         else if (std::chrono::steady_clock::now() > deadline)
+            break;
+      }
+
+      if (_matches.size() != num_found)
+         f.view_->refresh(*this);
+      if (on_find_all)
+         on_find_all(_matches.size(), done);
+      return !done;
+   }
+
+   bool basic_text_box::replace_next(view& view_, std::u32string_view pattern, std::u32string_view with)
+   {
+      if (!editable() || pattern.empty())
+         return false;
+
+      bool replaced = false;
+      auto _text = get_text();
+      auto start = std::min(_select_start, _select_end);
+      auto end = std::max(_select_start, _select_end);
+      if (start != -1 && _text.substr(start, end-start) == pattern)
+      {
+         auto undo_f = capture_state();
+         std::u32string s{_text};
+         s.replace(start, end-start, with);
+         edit_text(s, {std::size_t(start), std::size_t(end-start), with.size()});
+         _select_start = _select_end = start + int(with.size());
+         add_undo(view_, _typing_state, undo_f, capture_state());
+         replaced = true;
+      }
+      find_next(pattern);
+      return replaced;
+   }
+
+   std::size_t basic_text_box::replace_all(view& view_, std::u32string_view pattern, std::u32string_view with)
+   {
+      if (!editable() || pattern.empty())
+         return 0;
+
+      // Build the new text in a single pass
+      auto _text = get_text();
+      std::u32string s;
+      std::size_t n = 0;
+      std::size_t pos = 0;
+      for (auto i = _text.find(pattern); i != _text.npos; i = _text.find(pattern, pos))
+      {
+         if (n++ == 0)
+            s.reserve(_text.size());
+         s.append(_text.substr(pos, i-pos));
+         s.append(with);
+         pos = i + pattern.size();
+      }
+      if (n == 0)
+         return 0;
+      s.append(_text.substr(pos));
+
+      auto undo_f = capture_state();
+      set_text(s);
+      add_undo(view_, _typing_state, undo_f, capture_state());
+      return n;
+   }
+
    ////////////////////////////////////////////////////////////////////////////
    // Input Text Box
    ////////////////////////////////////////////////////////////////////////////
@@ -1016,38 +1685,36 @@ namespace cycfi { namespace elements
       return basic_text_box::key(ctx, k);
    }
 
-   void basic_input_box::paste(view& /* v */, int start, int end)
+   void basic_input_box::paste(view& v, int start, int end)
    {
       if (start != -1)
       {
-         auto  end_ = std::max(start, end);
-         auto  start_ = std::min(start, end);
-
-         std::string clip = clipboard();
-         if (clip.empty())
-            return;
-
-         std::string ins;
-
-         // Copy clip ito ins, stop when a newline is found.
-         // Also, limit ins to input_box_text_limit characters.
-         char const* p = &clip[0];
-         char const* last = p + clip.size();
-
-         auto const max_chars = get_theme().input_box_text_limit;
-         for (std::size_t i = 0; (i < max_chars) && (p != last); ++p, ++i)
-         {
-            if (is_newline(uint8_t(*p)))
-               break;
-            ins += *p;
-         }
-
-         start_ += replace(start_, end_-start_, ins);
-         select_start(start_);
-         select_end(start_);
-
-         if (on_text)
-            on_text(to_utf8(get_text()));
+         request_paste(v,
+            [this, start, end](std::u32string_view clip)
+            {
+               if (clip.empty())
+                  return;
+
+               // Paste up to the first newline, and limit the text to
+               // input_box_text_limit characters.
+               auto const max_chars = get_theme().input_box_text_limit;
+               auto  n = std::find_if(clip.begin(), clip.end(), [](char32_t c) { return is_newline(c); }) - clip.begin();
+               auto  ins = clip.substr(0, std::min<std::size_t>(n, max_chars));
+
+               auto  size = int(get_text().size());
+               auto  end_ = std::min(std::max(start, end), size);
+               auto  start_ = std::min(std::min(start, end), end_);
+
+               std::u32string text{get_text()};
+               text.replace(start_, end_-start_, ins);
+               edit_text(text, {std::size_t(start_), std::size_t(end_-start_), ins.size()});
+               select_start(start_ + int(ins.size()));
+               select_end(start_ + int(ins.size()));
+
+               if (on_text)
+                  on_text(to_utf8(get_text()));
+            }
+         );
       }
    }
 
@@ -8,50 +8,198 @@
 
 namespace cycfi { namespace elements
 {
-   rect tooltip_element::tip_bounds(context const& ctx) const
+   namespace
    {
-      auto limits_ = _tip->limits(ctx);
+      element& empty_tip()
+      {
+         static element empty_;
+         return empty_;
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // tooltip_overlay_element
+   ////////////////////////////////////////////////////////////////////////////
+   view_limits tooltip_overlay_element::limits(basic_context const& /* ctx */) const
+   {
+      // The overlay should never constrain the view's limits
+      return full_limits;
+   }
+
+   element const& tooltip_overlay_element::subject() const
+   {
+      return _tip? *_tip : empty_tip();
+   }
+
+   element& tooltip_overlay_element::subject()
+   {
+      return _tip? *_tip : empty_tip();
+   }
+
+   void tooltip_overlay_element::draw(context const& ctx)
+   {
+      if (_tip)
+         floating_element::draw(ctx);
+   }
+
+   element* tooltip_overlay_element::hit_test(context const&, point p, bool leaf, bool control)
+   {
+      unused(leaf, control);
+      return (_tip && bounds().includes(p))? this : nullptr;
+   }
+
+   bool tooltip_overlay_element::cursor(context const& ctx, point p, cursor_tracking status)
+   {
+      if (!_tip)
+         return false;
+
+      bool r = floating_element::cursor(ctx, p, status);
+      _cursor_in_tip = status != cursor_tracking::leaving;
+      if (!_cursor_in_tip && !_anchor.includes(p))
+         close(_owner);
+      return r;
+   }
+
+   rect tooltip_overlay_element::device_to_overlay(rect r) const
+   {
+      auto s = _view.hdpi_scale() * _view.scale();
+      return {r.left / s, r.top / s, r.right / s, r.bottom / s};
+   }
+
+   void tooltip_overlay_element::refresh_tip()
+   {
+      _view.refresh_layers(bounds());
+   }
+
+   void tooltip_overlay_element::open(
+      void const* owner, rect anchor, duration delay
+    , tip_function tip, hover_function on_hover
+   )
+   {
+      if (is_open(owner))
+         return;
+
+      bool warm = is_visible();
+      close(_owner);
+
+      _owner = owner;
+      _anchor = device_to_overlay(anchor);
+      _make_tip = std::move(tip);
+      _on_hover = std::move(on_hover);
+
+      if (warm)
+      {
+         show();
+      }
+      else
+      {
+         _timer = _view.post(std::chrono::duration_cast<std::chrono::milliseconds>(delay),
+            [this, owner]()
+            {
+               if (_owner == owner && !_tip)
+                  show();
+            }
+         );
+      }
+   }
+
+   void tooltip_overlay_element::show()
+   {
+      _tip = _make_tip? _make_tip() : element_ptr{};
+      _make_tip = nullptr;
+      if (!_tip)
+      {
+         _owner = nullptr;
+         return;
+      }
+
+      // Lay out the tip only. We do not need to lay out the whole view.
+      using artist::image;
+      using artist::offscreen_image;
+
+      image img{1, 1};
+      offscreen_image offscr{img};
+      canvas cnv{offscr.context()};
+      basic_context bctx{_view, cnv};
+      scoped_theme thm{_view.local_theme()};
+
+      auto limits_ = _tip->limits(bctx);
       auto w = limits_.min.x;
       auto h = limits_.min.y;
-      return rect{0, 0, w, h}.move_to(ctx.bounds.left, ctx.bounds.top-h);
+      bounds(rect{0, 0, w, h}.move_to(_anchor.left, _anchor.top-h));
+
+      context ctx{_view, cnv, this, bounds()};
+      _tip->layout(ctx);
+
+      if (_on_hover)
+         _on_hover(true);
+
+      // The overlay is added to the view only once. After that, it is
+      // simply brought to the front if other layers have been added.
+      auto self = shared_from_this();
+      if (!_view.is_open(self))
+         _view.add(self);
+      else
+         _view.move_to_front(self);
+      refresh_tip();
+   }
+
+   void tooltip_overlay_element::close(void const* owner)
+   {
+      if (!is_open(owner))
+         return;
+
+      if (auto timer = _timer.lock())
+         timer->cancel();
+      _timer.reset();
+
+      auto on_hover = std::move(_on_hover);
+      _on_hover = nullptr;
+      _make_tip = nullptr;
+      _owner = nullptr;
+      _cursor_in_tip = false;
+
+      if (_tip)
+      {
+         refresh_tip();
+         _tip.reset();
+         if (on_hover)
+            on_hover(false);
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // tooltip_element
+   ////////////////////////////////////////////////////////////////////////////
+   tooltip_element::~tooltip_element()
+   {
+      // The overlay must not call back into a tooltip that no longer exists
+      if (auto overlay = _overlay.lock())
+         overlay->close(this);
    }
 
    bool tooltip_element::cursor(context const& ctx, point p, cursor_tracking status)
    {
+      auto& overlay = ctx.view.tooltip_overlay();
       if (status != cursor_tracking::leaving)
       {
-         if (_tip_status != tip_visible)
+         if (!overlay.is_open(this))
          {
-            _tip_status = tip_delayed;
-            _tip->bounds(tip_bounds(ctx));
-            ctx.view.post(std::chrono::duration_cast<std::chrono::milliseconds>(_delay),
-               [this, &view_ = ctx.view, bounds = ctx.bounds]()
-               {
-                  if (_tip_status == tip_delayed)
-                  {
-                     _tip->on_cursor =
-                        [this, &view_, bounds](point p, cursor_tracking status)
-                        {
-                           _cursor_in_tip = status != cursor_tracking::leaving;
-                           if (!_cursor_in_tip && !bounds.includes(p))
-                              close_tip(view_);
-                        };
-
-                     on_hover(true);
-                     _tip_status = tip_visible;
-                     _tip->open(view_);
-                  }
-               }
+            _overlay = std::static_pointer_cast<tooltip_overlay_element>(overlay.shared_from_this());
+            auto tl = ctx.canvas.user_to_device(ctx.bounds.top_left());
+            auto br = ctx.canvas.user_to_device(ctx.bounds.bottom_right());
+            overlay.open(this, {tl.x, tl.y, br.x, br.y}, _delay, _tip,
+               [this](bool visible) { on_hover(visible); }
             );
          }
       }
       else
       {
          ctx.view.post(
-            [this, &view_ = ctx.view]()
+            [this, &overlay]()
             {
-               if (!_cursor_in_tip)
-                  close_tip(view_);
+               if (!overlay.cursor_in_tip())
+                  overlay.close(this);
             }
          );
       }
@@ -59,25 +207,11 @@ namespace cycfi { namespace elements
       return base_type::cursor(ctx, p, status);
    }
 
-   void tooltip_element::close_tip(view& view_)
-   {
-      if (_tip_status != tip_hidden)
-      {
-         if (_tip_status == tip_visible)
-         {
-            on_hover(false);
-            _tip->close(view_);
-         }
-         _tip_status = tip_hidden;
-         _cursor_in_tip = false;
-      }
-   }
-
    bool tooltip_element::key(context const& ctx, key_info k)
    {
       auto r = base_type::key(ctx, k);
       if (!r && k.key == key_code::escape)
-         close_tip(ctx.view);
+         ctx.view.tooltip_overlay().close(this);
       return r;
    }
 }}
@@ -4,49 +4,275 @@
    Distributed under the MIT License [ https://opensource.org/licenses/MIT ]
 =============================================================================*/
 #include <elements/support/payload.hpp>
+#include <unordered_map>
+#include <deque>
+#include <atomic>
+#include <mutex>
+#include <algorithm>
 
 namespace cycfi::elements
 {
-   bool contains_filepaths(payload const& data)
+   ////////////////////////////////////////////////////////////////////////////
+   // payload_buffer
+   ////////////////////////////////////////////////////////////////////////////
+   payload_buffer::payload_buffer(std::string text)
    {
-      // Make sure there's a "text/uri-list" MIME data type and that there's
-      // at least one valid file URI.
-      auto i = data.find("text/uri-list");
-      if (i != data.end())
+      auto p = std::make_shared<std::string const>(std::move(text));
+      _data = p->data();
+      _size = p->size();
+      _owner = std::move(p);
+   }
+
+   payload_buffer::payload_buffer(char const* text)
+    : payload_buffer(std::string{text})
+   {}
+
+   payload_buffer::payload_buffer(std::vector<std::byte> bytes)
+   {
+      auto p = std::make_shared<std::vector<std::byte> const>(std::move(bytes));
+      _data = reinterpret_cast<char const*>(p->data());
+      _size = p->size();
+      _owner = std::move(p);
+   }
+
+   payload_buffer::payload_buffer(owner_ptr owner, void const* data, std::size_t size)
+    : _owner(std::move(owner))
+    , _data(static_cast<char const*>(data))
+    , _size(size)
+   {}
+
+   ////////////////////////////////////////////////////////////////////////////
+   // payload_data
+   ////////////////////////////////////////////////////////////////////////////
+   payload_data::payload_data(payload_buffer buffer)
+    : _state(std::make_shared<state>(state{{}, std::move(buffer)}))
+   {}
+
+   payload_data::payload_data(std::string text)
+    : payload_data(payload_buffer{std::move(text)})
+   {}
+
+   payload_data::payload_data(char const* text)
+    : payload_data(payload_buffer{text})
+   {}
+
+   payload_data::payload_data(std::vector<std::byte> bytes)
+    : payload_data(payload_buffer{std::move(bytes)})
+   {}
+
+   payload_data::payload_data(provider_function provide)
+    : _state(std::make_shared<state>(state{std::move(provide), {}}))
+   {}
+
+   bool payload_data::is_ready() const
+   {
+      return !_state || !_state->provide;
+   }
+
+   payload_buffer const& payload_data::buffer() const
+   {
+      static payload_buffer const empty_;
+      if (!_state)
+         return empty_;
+
+      if (_state->provide)
+      {
+         // Provide the data only once. Release the provider afterwards,
+         // along with anything it holds on to.
+         auto provide = std::move(_state->provide);
+         _state->provide = nullptr;
+         _state->buffer = provide();
+      }
+      return _state->buffer;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // MIME types
+   ////////////////////////////////////////////////////////////////////////////
+   namespace
+   {
+      // The interned MIME types. The keys are views of the strings in
+      // `names`, which never move, so lookups do not allocate.
+      struct mime_table
+      {
+         std::unordered_map<std::string_view, mime_id> ids;
+         std::deque<std::string> names;
+         std::atomic<std::size_t> size{0};
+         std::mutex mutex;
+      };
+
+      mime_table& get_mime_table()
+      {
+         static mime_table table;
+         return table;
+      }
+   }
+
+   mime_id intern_mime_type(std::string_view mime_type)
+   {
+      auto& table = get_mime_table();
+      std::lock_guard<std::mutex> lock(table.mutex);
+      if (auto i = table.ids.find(mime_type); i != table.ids.end())
+         return i->second;
+
+      auto id = table.names.size();
+      table.names.emplace_back(mime_type);
+      table.ids.emplace(table.names.back(), id);
+      table.size = table.names.size();
+      return id;
+   }
+
+   mime_id find_mime_type(std::string_view mime_type)
+   {
+      auto& table = get_mime_table();
+      std::lock_guard<std::mutex> lock(table.mutex);
+      auto i = table.ids.find(mime_type);
+      return (i == table.ids.end())? no_mime_id : i->second;
+   }
+
+   std::size_t num_mime_types()
+   {
+      return get_mime_table().size;
+   }
+
+   void mime_set::insert(mime_id id)
+   {
+      auto i = id / block_bits;
+      if (i >= _bits.size())
+         _bits.resize(i+1, 0);
+      _bits[i] |= block{1} << (id % block_bits);
+   }
+
+   bool mime_set::contains(mime_id id) const
+   {
+      auto i = id / block_bits;
+      return i < _bits.size() && (_bits[i] & (block{1} << (id % block_bits)));
+   }
+
+   bool mime_set::intersects(mime_set const& other) const
+   {
+      auto n = std::min(_bits.size(), other._bits.size());
+      for (std::size_t i = 0; i != n; ++i)
       {
-         std::string_view text = std::get<std::string>(i->second);
-         return text.find("file://") == 0;
+         if (_bits[i] & other._bits[i])
+            return true;
       }
       return false;
    }
 
-   std::vector<fs::path> get_filepaths(payload const& data)
+   bool mime_set::empty() const
    {
-      std::vector<fs::path> paths;
-      if (auto i = data.find("text/uri-list"); i != data.end())
+      for (auto b : _bits)
       {
-         std::string_view text = std::get<std::string>(i->second);
-         size_t pos = 0;
-         size_t found;
+         if (b)
+            return false;
+      }
+      return true;
+   }
 
-         auto fix_path = [&](std::string_view path) -> std::string_view
+   ////////////////////////////////////////////////////////////////////////////
+   // payload
+   ////////////////////////////////////////////////////////////////////////////
+   mime_set const& payload::mime_types() const
+   {
+      // Keys that are not interned are not accepted by any drop target, so
+      // we do not intern them. We have to look them up again, though, when
+      // new MIME types have been interned since.
+      auto num_types = num_mime_types();
+      if (!_mime_types_valid || _num_mime_types != num_types)
+      {
+         _mime_types.clear();
+         for (auto const& [key, data] : _map)
          {
-            if (path.find("file://") == 0)
-               return path.substr(7);
-            return std::string_view{""};
-         };
+            auto id = find_mime_type(key);
+            if (id != no_mime_id)
+               _mime_types.insert(id);
+         }
+         _num_mime_types = num_types;
+         _mime_types_valid = true;
+      }
+      return _mime_types;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   // file_paths
+   ////////////////////////////////////////////////////////////////////////////
+   namespace
+   {
+      constexpr std::string_view file_scheme = "file://";
+   }
+
+   file_paths::iterator::iterator(std::string_view text)
+    : _rest(text)
+    , _done(false)
+   {
+      next();
+   }
+
+   void file_paths::iterator::next()
+   {
+      while (!_rest.empty())
+      {
+         auto found = _rest.find('\n');
+         auto line = _rest.substr(0, found);
+         _rest = (found == std::string_view::npos)? std::string_view{} : _rest.substr(found+1);
+
+         // text/uri-list lines are supposed to be terminated by CRLF
+         if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
 
-         while ((found = text.find('\n', pos)) != std::string::npos)
+         if (line.substr(0, file_scheme.size()) == file_scheme)
          {
-            if (auto path = fix_path(text.substr(pos, found - pos)); !path.empty())
-               paths.push_back(path);
-            pos = found + 1;
+            line.remove_prefix(file_scheme.size());
+            if (!line.empty())
+            {
+               _path = line;
+               return;
+            }
          }
-         if (auto path = fix_path(text.substr(pos)); !path.empty())
-            paths.push_back(path);
       }
-      return paths;
+      _path = {};
+      _done = true;
    }
-}
 
+   file_paths::iterator& file_paths::iterator::operator++()
+   {
+      next();
+      return *this;
+   }
+
+   file_paths::iterator file_paths::iterator::operator++(int)
+   {
+      auto r = *this;
+      next();
+      return r;
+   }
+
+   bool file_paths::iterator::operator==(iterator const& rhs) const
+   {
+      if (_done || rhs._done)
+         return _done == rhs._done;
+      return _path.data() == rhs._path.data();
+   }
+
+   file_paths::file_paths(payload const& data)
+   {
+      if (auto i = data.find("text/uri-list"); i != data.end())
+         _buffer = i->second.buffer();
+   }
 
+   bool contains_filepaths(payload const& data)
+   {
+      // Make sure there's a "text/uri-list" MIME data type and that there's
+      // at least one valid file URI.
+      return !file_paths{data}.empty();
+   }
+
+   std::vector<fs::path> get_filepaths(payload const& data)
+   {
+      std::vector<fs::path> paths;
+      for (auto path : file_paths{data})
+         paths.emplace_back(path);
+      return paths;
+   }
+}
@@ -6,6 +6,8 @@
 #include <elements/support/text_utils.hpp>
 #include <infra/utf8_utils.hpp>
 #include <elements/support/theme.hpp>
+#include <algorithm>
+#include <cstring>
 
 namespace cycfi { namespace elements
 {
@@ -42,4 +44,36 @@ namespace cycfi { namespace elements
       auto  height = info.ascent + info.descent + info.leading;
       return {info.size.x, height};
    }
+
+   text_edit find_edit(std::u32string_view from, std::u32string_view to)
+   {
+      auto n = std::min(from.size(), to.size());
+      std::size_t prefix = std::mismatch(from.begin(), from.begin() + n, to.begin()).first - from.begin();
+      std::size_t suffix = 0;
+      while (suffix < n - prefix && from[from.size()-1-suffix] == to[to.size()-1-suffix])
+         ++suffix;
+      return {prefix, from.size() - prefix - suffix, to.size() - prefix - suffix};
+   }
+
+   void label_text::assign(std::string_view text)
+   {
+      if (text.size() <= small_size)
+      {
+         std::memmove(_small, text.data(), text.size());
+         _size = std::uint8_t(text.size());
+         _shared.reset();
+      }
+      else
+      {
+         _shared = std::make_shared<std::string const>(text);
+      }
+   }
+
+   void label_text::assign(shared_string text)
+   {
+      if (text)
+         _shared = std::move(text);
+      else
+         assign(std::string_view{});
+   }
 }}
@@ -6,6 +6,9 @@
 #include <elements/support/theme.hpp>
 #include <elements/element/dial.hpp>
 #include <elements/view.hpp>
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 namespace cycfi { namespace elements
 {
@@ -63,6 +66,7 @@ namespace cycfi { namespace elements
     , text_box_font_color        {basic_font_color}
     , text_box_font              {font_descr{"Open Sans", 14.0}}
     , text_box_hilite_color      {rgba(0, 127, 255, 100)}
+    , text_box_match_color       {rgba(255, 200, 0, 90)}
     , text_box_caret_color       {rgba(0, 190, 255, 255)}
     , text_box_caret_width       {1.2}
     , inactive_font_color        {rgba(127, 127, 127, 150)}
@@ -90,20 +94,124 @@ namespace cycfi { namespace elements
    {
    }
 
-   // The global theme
-   theme& global_theme::_theme()
+   namespace
    {
-      static theme thm;
-      return thm;
+      // The global theme snapshot, and its generation, incremented each
+      // time set_theme replaces the snapshot. Both are guarded by
+      // global_mutex(). The generation is also kept in an atomic, so that
+      // checking for a new snapshot does not lock.
+      struct global_theme_info
+      {
+         theme_ptr            thm = std::make_shared<theme const>();
+         std::size_t          generation = 0;
+      };
+
+      global_theme_info& global_theme()
+      {
+         static global_theme_info info;
+         return info;
+      }
+
+      std::mutex& global_mutex()
+      {
+         static std::mutex mutex;
+         return mutex;
+      }
+
+      std::atomic<std::size_t> global_generation{0};
+
+      // Outside any scoped_theme, each thread pins the global snapshot it
+      // last saw, and pins the new one when set_theme replaces it. The
+      // snapshots pinned before are retired, not released, so references
+      // obtained from get_theme() remain valid until the thread enters its
+      // next outermost scoped_theme (e.g. the view's next draw or event).
+      struct pinned_theme
+      {
+         using retired_themes = std::vector<theme_ptr>;
+
+         theme_ptr            thm;
+         std::size_t          generation = 0;
+         retired_themes       retired;
+      };
+
+      thread_local pinned_theme pinned;
+
+      theme_ptr const& pin_global_theme()
+      {
+         if (!pinned.thm
+            || pinned.generation != global_generation.load(std::memory_order_acquire))
+         {
+            if (pinned.thm)
+               pinned.retired.push_back(std::move(pinned.thm));
+
+            std::lock_guard<std::mutex> lock(global_mutex());
+            pinned.thm = global_theme().thm;
+            pinned.generation = global_theme().generation;
+         }
+         return pinned.thm;
+      }
+
+      // The current theme of this thread, installed by scoped_theme. If
+      // null, the global theme is current.
+      thread_local theme_ptr const* current_theme = nullptr;
    }
 
    theme const& get_theme()
    {
-      return global_theme::_theme();
+      return current_theme? **current_theme : *pin_global_theme();
+   }
+
+   theme_ptr get_theme_ptr()
+   {
+      return current_theme? *current_theme : pin_global_theme();
    }
 
    void set_theme(theme const& thm)
    {
-      global_theme::_theme() = thm;
+      set_theme(std::make_shared<theme const>(thm));
+   }
+
+   void set_theme(theme_ptr thm)
+   {
+      if (thm)
+      {
+         std::lock_guard<std::mutex> lock(global_mutex());
+         auto& info = global_theme();
+         info.thm.swap(thm);
+         global_generation.store(++info.generation, std::memory_order_release);
+      }
+   }
+
+   scoped_theme::scoped_theme(theme_ptr thm)
+    : _theme(std::move(thm))
+   {
+      if (_theme)
+      {
+         // Entering the outermost scope: the global snapshots this thread
+         // pinned before can go.
+         if (!current_theme)
+            pinned.retired.clear();
+         _save = current_theme;
+         current_theme = &_theme;
+         _active = true;
+      }
+   }
+
+   scoped_theme::scoped_theme(scoped_theme&& rhs)
+    : _theme(rhs._theme)
+    , _save(rhs._save)
+    , _active(rhs._active)
+   {
+      // Take over from rhs. Note that we keep our own copy of the theme_ptr,
+      // so we have to point the current theme to it.
+      if (_active && current_theme == &rhs._theme)
+         current_theme = &_theme;
+      rhs._active = false;
+   }
+
+   scoped_theme::~scoped_theme()
+   {
+      if (_active)
+         current_theme = _save;
    }
 }}
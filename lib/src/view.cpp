@@ -6,6 +6,9 @@
 #include <elements/view.hpp>
 #include <elements/window.hpp>
 #include <elements/support/context.hpp>
+#include <elements/element/floating.hpp>
+#include <elements/element/tooltip.hpp>
+#include <algorithm>
 
 namespace cycfi { namespace elements
 {
@@ -41,16 +44,44 @@ namespace cycfi { namespace elements
       _io.stop();
    }
 
+   namespace
+   {
+      // Install the view's theme (or pin the global theme) while we are
+      // doing something with the view's content
+      scoped_theme view_theme(view const& self)
+      {
+         auto thm = self.local_theme();
+         return scoped_theme{thm? thm : get_theme_ptr()};
+      }
+   }
+
+   tooltip_overlay_element& view::tooltip_overlay()
+   {
+      if (!_tooltip_overlay)
+         _tooltip_overlay = std::make_shared<tooltip_overlay_element>(*this);
+      return *_tooltip_overlay;
+   }
+
+   void view::local_theme(theme_ptr thm)
+   {
+      _local_theme = std::move(thm);
+      set_limits();
+      layout();
+   }
+
    void view::set_limits()
    {
       if (_content.empty())
          return;
 
+      auto thm = view_theme(*this);
+
       image img{1, 1};
       offscreen_image offscr{img};
       canvas cnv{offscr.context()};
 
       // Update the limits and constrain the window size to the limits
+      ++_layout_pass;
       basic_context bctx{*this, cnv};
       auto limits_ = _main_element.limits(bctx);
       if (limits_.min != _current_limits.min || limits_.max != _current_limits.max)
@@ -67,6 +98,7 @@ namespace cycfi { namespace elements
          return;
 
       _dirty = dirty_;
+      auto thm = view_theme(*this);
 
       // Update the limits and constrain the window size to the limits
       set_limits();
@@ -79,6 +111,7 @@ namespace cycfi { namespace elements
       if (subj_bounds != _current_bounds)
       {
          _current_bounds = subj_bounds;
+         ++_layout_pass;
          _main_element.layout(ctx);
       }
 
@@ -96,6 +129,7 @@ namespace cycfi { namespace elements
          canvas cnv{offscr.context()};
          context ctx {self, cnv, &self.main_element(), _current_bounds};
          cnv.pre_scale(self.hdpi_scale());
+         auto thm = view_theme(self);
 
          f(ctx, self.main_element());
       }
@@ -106,6 +140,7 @@ namespace cycfi { namespace elements
       if (_current_bounds.is_empty())
          return;
 
+      ++_layout_pass;
       call(
          [](auto const& ctx, auto& _main_element) { _main_element.layout(ctx); },
          *this, _current_bounds
@@ -119,6 +154,7 @@ namespace cycfi { namespace elements
       if (_current_bounds.is_empty())
          return;
 
+      ++_layout_pass;
       call(
          [](auto const& ctx, auto& _main_element) { _main_element.layout(ctx); },
          *this, _current_bounds
@@ -127,6 +163,210 @@ namespace cycfi { namespace elements
       refresh(element);
    }
 
+   namespace
+   {
+      // Floating layers (popups, tooltips, etc.) cover only their floating
+      // bounds. Other layers cover the whole area given by the layer.
+      rect layer_area(element& e, rect bounds)
+      {
+         if (auto f = dynamic_cast<floating_element*>(&e))
+            return f->bounds();
+         return bounds;
+      }
+
+      template <typename F>
+      void in_layer_context(F f, view& self, layer_composite& content, std::size_t index, rect bounds)
+      {
+         call(
+            [&](auto const& ctx, auto& _main_element)
+            {
+               context sctx{ctx, &_main_element.subject(), ctx.bounds};
+               _main_element.prepare_subject(sctx);
+               auto& e = content.at(index);
+               context ectx{sctx, &e, content.bounds_of(sctx, index)};
+               f(ectx, e);
+               _main_element.restore_subject(sctx);
+            },
+            self, bounds
+         );
+      }
+   }
+
+   void view::layout_layer(std::size_t index)
+   {
+      if (_current_bounds.is_empty())
+         return;
+
+      // Lay out the layer at `index` only, and refresh only the area it covers
+      ++_layout_pass;
+      in_layer_context(
+         [this](auto const& ctx, element& e)
+         {
+            e.layout(ctx);
+            refresh(ctx, layer_area(e, ctx.bounds));
+         },
+         *this, _content, index, _current_bounds
+      );
+   }
+
+   void view::refresh_layer(std::size_t index)
+   {
+      if (_current_bounds.is_empty())
+         return;
+
+      in_layer_context(
+         [this](auto const& ctx, element& e)
+         {
+            refresh(ctx, layer_area(e, ctx.bounds));
+         },
+         *this, _content, index, _current_bounds
+      );
+   }
+
+   int view::focus_layer() const
+   {
+      auto focus = _content.focus();
+      for (std::size_t i = 0; i != _content.size(); ++i)
+      {
+         if (_content[i].get() == focus)
+            return int(i);
+      }
+      return -1;
+   }
+
+   // Like end_focus and begin_focus, but refresh only the layer that loses
+   // or gains the focus, instead of the whole view.
+   void view::end_layer_focus()
+   {
+      if (_content.empty() || !_is_focus)
+         return;
+
+      auto index = focus_layer();
+      _main_element.end_focus();
+      if (index >= 0)
+         refresh_layer(index);
+   }
+
+   void view::begin_layer_focus()
+   {
+      if (_content.empty() || !_is_focus)
+         return;
+
+      _main_element.begin_focus();
+      auto index = focus_layer();
+      if (index >= 0)
+         refresh_layer(index);
+   }
+
+   void view::add(element_ptr e)
+   {
+      // We'll defer this call just to be safe, to give the trigger that
+      // initiated this call (e.g. button on_click) a chance to return.
+      if (e)
+      {
+         if (_content.empty() || is_open(e))
+            return;
+
+         io().post(
+            [e, this]
+            {
+               // Check again. The same element may have been added more
+               // than once before we got here.
+               if (!open_layers().insert(e).second)
+                  return;
+
+               end_layer_focus();
+               _content.push_back(e);
+               layout_layer(_content.size()-1);
+               _is_focus = true;
+               begin_layer_focus();
+               _is_focus = _main_element.focus();
+            }
+         );
+      }
+   }
+
+   void view::remove(element_ptr e)
+   {
+      // We want to dismiss the element, but we can't do it immediately
+      // because we need to retain the trigger that initiated this call (e.g.
+      // button on_click), otherwise there's nothing to return to. So, we
+      // post a function that is called at idle time.
+      if (e)
+      {
+         io().post(
+            [e, this]
+            {
+               if (open_layers().erase(e) == 0)
+                  return;
+
+               auto i = std::find(_content.begin(), _content.end(), e);
+               if (i != _content.end())
+               {
+                  // Removing a layer does not affect the layout of the
+                  // other layers. We only need to refresh the area it
+                  // used to cover.
+                  end_layer_focus();
+                  refresh_layer(i - _content.begin());
+                  _content.erase(i);
+                  _content.reset();
+                  _is_focus = true;
+                  begin_layer_focus();
+                  _is_focus = _main_element.focus();
+               }
+            }
+         );
+      }
+   }
+
+   void view::move_to_front(element_ptr e)
+   {
+      if (e && !_content.empty() && _content.back() != e)
+      {
+         io().post(
+            [e, this]
+            {
+               if (!is_open(e))
+                  return;
+
+               auto i = std::find(_content.begin(), _content.end(), e);
+               if (i != _content.end())
+               {
+                  end_layer_focus();
+                  std::rotate(i, i+1, _content.end());
+                  _content.reset();
+                  refresh_layer(_content.size()-1);
+                  begin_layer_focus();
+               }
+            }
+         );
+      }
+   }
+
+   void view::move_to_back(element_ptr e)
+   {
+      if (e && !_content.empty() && _content.front() != e)
+      {
+         io().post(
+            [e, this]
+            {
+               if (!is_open(e))
+                  return;
+
+               auto i = std::find(_content.begin(), _content.end(), e);
+               if (i != _content.end())
+               {
+                  end_layer_focus();
+                  std::rotate(_content.begin(), i, i+1);
+                  _content.reset();
+                  refresh_layer(0);
+                  begin_layer_focus();
+               }
+            }
+         );
+      }
+   }
+
    float view::scale() const
    {
       return _main_element.scale();
@@ -138,6 +378,42 @@ namespace cycfi { namespace elements
       refresh();
    }
 
+   namespace
+   {
+      // Zooming settles when there are no zoom steps for this long
+      constexpr auto zoom_settle_time = std::chrono::milliseconds(250);
+   }
+
+   void view::begin_zoom()
+   {
+      _main_element.begin_zoom();
+   }
+
+   void view::end_zoom()
+   {
+      if (_zoom_timer)
+      {
+         _zoom_timer->cancel();
+         _zoom_timer.reset();
+      }
+
+      if (_main_element.is_zooming())
+      {
+         // Lay out and draw the content at the final scale
+         _main_element.end_zoom();
+         layout();
+      }
+   }
+
+   void view::zoom(float val)
+   {
+      begin_zoom();
+      scale(val);
+      if (_zoom_timer)
+         _zoom_timer->cancel();
+      _zoom_timer = post(zoom_settle_time, [this]{ end_zoom(); });
+   }
+
    void view::refresh()
    {
       // Allow refresh to be called from another thread
@@ -167,6 +443,15 @@ namespace cycfi { namespace elements
       refresh({tl.x, tl.y, br.x, br.y});
    }
 
+   void view::refresh_layers(rect area)
+   {
+      // `area` is in the coordinate space of the layers (e.g. the bounds of
+      // a floating layer), which is scaled by the view's scale and the
+      // display's hdpi scale.
+      auto s = hdpi_scale() * scale();
+      refresh({area.left * s, area.top * s, area.right * s, area.bottom * s});
+   }
+
    void view::refresh(element& element, int outward)
    {
       if (_current_bounds.is_empty())
@@ -264,6 +549,10 @@ namespace cycfi { namespace elements
 
    bool view::key(key_info const& k)
    {
+      // Shortcuts come first, without walking the elements
+      if (shortcut(k))
+         return true;
+
       if (_content.empty())
          return false;
 
@@ -278,6 +567,72 @@ namespace cycfi { namespace elements
       return handled;
    }
 
+   view::shortcut_id view::add_shortcut(shortcut_key key, shortcut_function f)
+   {
+      auto id = _next_shortcut_id++;
+      _shortcuts[key.key].push_back(
+         {id, key, std::make_shared<shortcut_function>(std::move(f))});
+      ++_shortcuts_generation;
+      return id;
+   }
+
+   void view::remove_shortcut(shortcut_id id)
+   {
+      for (auto i = _shortcuts.begin(); i != _shortcuts.end(); ++i)
+      {
+         auto& v = i->second;
+         auto j = std::find_if(v.begin(), v.end(),
+            [id](shortcut_info const& info) { return info.id == id; });
+         if (j != v.end())
+         {
+            v.erase(j);
+            if (v.empty())
+               _shortcuts.erase(i);
+            ++_shortcuts_generation;
+            return;
+         }
+      }
+   }
+
+   bool view::shortcut(key_info const& k)
+   {
+      if (k.action != key_action::press && k.action != key_action::repeat)
+         return false;
+
+      auto i = _shortcuts.find(k.key);
+      std::size_t ix = 0;
+      while (i != _shortcuts.end() && ix != i->second.size())
+      {
+         auto const& info = i->second[ix++];
+         if (!info.key.matches(k))
+            continue;
+
+         // The function is held while it is called, in case it removes
+         // its own shortcut.
+         auto id = info.id;
+         auto f = info.f;
+         auto generation = _shortcuts_generation;
+         if ((*f)())
+            return true;
+
+         // The function added or removed shortcuts. The shortcuts are kept
+         // in the order they were added (by id), so we resume after the
+         // one we just called.
+         if (generation != _shortcuts_generation)
+         {
+            i = _shortcuts.find(k.key);
+            if (i != _shortcuts.end())
+            {
+               auto const& v = i->second;
+               ix = std::upper_bound(v.begin(), v.end(), id,
+                  [](shortcut_id id, shortcut_info const& info) { return id < info.id; }
+               ) - v.begin();
+            }
+         }
+      }
+      return false;
+   }
+
    bool view::text(text_info const& info)
    {
       if (_content.empty())
@@ -285,7 +640,7 @@ namespace cycfi { namespace elements
 
       bool handled = false;
       call(
-         [info, &handled](auto const& ctx, auto& _main_element)
+         [&info, &handled](auto const& ctx, auto& _main_element)
          {
             handled = _main_element.text(ctx, info);
          },
@@ -355,7 +710,7 @@ namespace cycfi { namespace elements
          return;
 
       call(
-         [info, status](auto const& ctx, auto& _main_element)
+         [&info, status](auto const& ctx, auto& _main_element)
          {
             _main_element.track_drop(ctx, info, status);
          },
@@ -370,7 +725,7 @@ namespace cycfi { namespace elements
 
       bool handled = false;
       call(
-         [info, &handled](auto const& ctx, auto& _main_element)
+         [&info, &handled](auto const& ctx, auto& _main_element)
          {
             handled = _main_element.drop(ctx, info);
          },
@@ -379,6 +734,42 @@ namespace cycfi { namespace elements
       return handled;
    }
 
+   namespace
+   {
+      constexpr auto frame_period = std::chrono::microseconds(1000000 / 60);
+   }
+
+   void view::on_frame(frame_function f)
+   {
+      _frame_functions.push_back(std::move(f));
+      if (!_frame_timer)
+      {
+         _last_frame = std::chrono::steady_clock::now();
+         _frame_timer = post(frame_period, [this]{ frame(); });
+      }
+   }
+
+   void view::frame()
+   {
+      auto now = std::chrono::steady_clock::now();
+      frame_duration dt = now - _last_frame;
+      _last_frame = now;
+
+      // The functions may add more functions while we are calling them
+      auto functions = std::move(_frame_functions);
+      _frame_functions.clear();
+      for (auto& f : functions)
+      {
+         if (f(dt))
+            _frame_functions.push_back(std::move(f));
+      }
+
+      if (_frame_functions.empty())
+         _frame_timer.reset();
+      else
+         _frame_timer = post(frame_period, [this]{ frame(); });
+   }
+
    void view::poll()
    {
       _io.poll();